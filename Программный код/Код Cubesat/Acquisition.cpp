@@ -0,0 +1,231 @@
+// Acquisition.cpp
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Acquisition.h"
+
+
+#define ACQ_COARSE_COUNT ((ACQ_FIELD_MAX - ACQ_FIELD_MIN) / ACQ_COARSE_STEP + 1)
+
+// ══════════════════════════════════════════════════════════════
+// ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+static bool inField(int16_t x, int16_t y) {
+    return x >= ACQ_FIELD_MIN && x <= ACQ_FIELD_MAX &&
+           y >= ACQ_FIELD_MIN && y <= ACQ_FIELD_MAX;
+}
+
+// Грубая сетка обходится «змейкой», чтобы перемещения не превышали шага
+static void coarsePoint(uint8_t index, int8_t &x, int8_t &y) {
+    uint8_t row = index / ACQ_COARSE_COUNT;
+    uint8_t col = index % ACQ_COARSE_COUNT;
+    if (row & 1) col = ACQ_COARSE_COUNT - 1 - col;
+    x = ACQ_FIELD_MIN + col * ACQ_COARSE_STEP;
+    y = ACQ_FIELD_MIN + row * ACQ_COARSE_STEP;
+}
+
+// Квадратная спираль: первые (2r+1)²-1 точек покрывают квадрат радиуса r
+static void spiralOffset(uint8_t index, int8_t &dx, int8_t &dy) {
+    static const int8_t dirX[4] = {1, 0, -1, 0};
+    static const int8_t dirY[4] = {0, 1, 0, -1};
+    dx = 0;
+    dy = 0;
+    uint8_t run = 1;
+    uint8_t dir = 0;
+    uint8_t left = index + 1;
+    while (left) {
+        for (uint8_t i = 0; i < run && left; i++, left--) {
+            dx += dirX[dir];
+            dy += dirY[dir];
+        }
+        if (dir & 1) run++;
+        dir = (dir + 1) & 3;
+    }
+}
+
+static void startRefine(AcqSearch &s, uint8_t step) {
+    s.phase = ACQ_REFINE;
+    s.centerX = s.bestX;
+    s.centerY = s.bestY;
+    s.gridStep = step;
+    s.index = 0xFF;  // первая точка выдаётся в advance()
+}
+
+static void startSpiral(AcqSearch &s, uint8_t radius) {
+    s.phase = ACQ_SPIRAL;
+    s.centerX = s.bestX;
+    s.centerY = s.bestY;
+    s.gridStep = 1;
+    s.index = 0xFF;
+    s.spiralPoints = (2 * radius + 1) * (2 * radius + 1) - 1;
+    s.spiralPass++;
+    for (uint8_t i = 0; i < 4; i++) s.neighbors[i] = 0;
+}
+
+// Субградусная оценка смещения пика по параболе через три отсчёта
+static float peakOffset(uint16_t minus, uint16_t center, uint16_t plus) {
+    float denom = (float)minus - 2.0f * center + (float)plus;
+    if (denom >= 0.0f) return 0.5f;
+    float d = ((float)minus - (float)plus) / (2.0f * denom);
+    if (d > 0.5f) d = 0.5f;
+    if (d < -0.5f) d = -0.5f;
+    return d;
+}
+
+static void startHold(AcqSearch &s) {
+    s.phase = ACQ_HOLD;
+    s.pointX = s.bestX;
+    s.pointY = s.bestY;
+    s.lossCount = 0;
+
+    if (s.bestX != s.centerX || s.bestY != s.centerY) {
+        s.errorTenths = 0xFF;
+        return;
+    }
+    float ex = peakOffset(s.neighbors[1], s.bestLevel, s.neighbors[0]);
+    float ey = peakOffset(s.neighbors[3], s.bestLevel, s.neighbors[2]);
+    float e = sqrtf(ex * ex + ey * ey) * 10.0f + 0.5f;
+    s.errorTenths = (e > 254.0f) ? 254 : (uint8_t)e;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ВЫБОР СЛЕДУЮЩЕЙ ТОЧКИ
+// ══════════════════════════════════════════════════════════════
+static void advance(AcqSearch &s) {
+    for (;;) {
+        switch (s.phase) {
+            case ACQ_COARSE:
+                if (++s.index < ACQ_COARSE_COUNT * ACQ_COARSE_COUNT) {
+                    coarsePoint(s.index, s.pointX, s.pointY);
+                    return;
+                }
+                if (s.bestLevel < ACQ_DETECT_LEVEL) {
+                    s.phase = ACQ_FAILED;
+                    return;
+                }
+                startRefine(s, ACQ_COARSE_STEP / 2);
+                break;
+
+            case ACQ_REFINE: {
+                if (++s.index < 9) {
+                    if (s.index == 4) break;  // центр уже измерен
+                    int16_t x = s.centerX + ((int8_t)(s.index % 3) - 1) * s.gridStep;
+                    int16_t y = s.centerY + ((int8_t)(s.index / 3) - 1) * s.gridStep;
+                    if (!inField(x, y)) break;
+                    s.pointX = x;
+                    s.pointY = y;
+                    return;
+                }
+                if (s.gridStep / 2 >= ACQ_FINE_STEP_MIN) {
+                    startRefine(s, s.gridStep / 2);
+                } else {
+                    s.spiralPass = 0;
+                    startSpiral(s, ACQ_SPIRAL_RADIUS);
+                }
+                break;
+            }
+
+            case ACQ_SPIRAL: {
+                if (++s.index < s.spiralPoints) {
+                    int8_t dx, dy;
+                    spiralOffset(s.index, dx, dy);
+                    int16_t x = s.centerX + dx;
+                    int16_t y = s.centerY + dy;
+                    if (!inField(x, y)) break;
+                    s.pointX = x;
+                    s.pointY = y;
+                    return;
+                }
+                if (s.bestLevel < ACQ_DETECT_LEVEL) {
+                    // Цель потеряна окончательно — поиск заново по всему полю
+                    s.phase = ACQ_COARSE;
+                    s.bestLevel = 0;
+                    s.index = 0;
+                    coarsePoint(0, s.pointX, s.pointY);
+                    return;
+                }
+                bool moved = (s.bestX != s.centerX || s.bestY != s.centerY);
+                if (moved && s.spiralPass < ACQ_SPIRAL_PASSES) {
+                    startSpiral(s, 1);
+                    break;
+                }
+                startHold(s);
+                return;
+            }
+
+            default:
+                return;
+        }
+    }
+}
+
+// ══════════════════════════════════════════════════════════════
+// ЗАПУСК
+// ══════════════════════════════════════════════════════════════
+void acqStart(AcqSearch &s) {
+    s.phase = ACQ_COARSE;
+    s.index = 0;
+    s.gridStep = ACQ_COARSE_STEP;
+    s.spiralPass = 0;
+    s.bestLevel = 0;
+    s.bestX = 0;
+    s.bestY = 0;
+    s.lossCount = 0;
+    s.errorTenths = 0xFF;
+    s.points = 0;
+    coarsePoint(0, s.pointX, s.pointY);
+}
+
+// ══════════════════════════════════════════════════════════════
+// ОБРАБОТКА ОТСЧЁТА ФОТОПРИЁМНИКА В ТЕКУЩЕЙ ТОЧКЕ
+// ══════════════════════════════════════════════════════════════
+void acqFeed(AcqSearch &s, uint16_t level) {
+    s.points++;
+
+    if (s.phase == ACQ_HOLD) {
+        if (level > s.bestLevel) s.bestLevel = level;
+        if (level < s.bestLevel / ACQ_HOLD_LOSS_DIV) {
+            if (++s.lossCount >= ACQ_HOLD_LOSS_COUNT) {
+                // Цель сместилась — повторное уточнение спиралью;
+                // прежняя оценка ошибки больше не действует
+                s.bestLevel = level;
+                s.errorTenths = 0xFF;
+                s.spiralPass = 0;
+                startSpiral(s, ACQ_SPIRAL_RADIUS);
+                advance(s);
+            }
+        } else {
+            s.lossCount = 0;
+        }
+        return;
+    }
+
+    if (s.phase == ACQ_FAILED) return;
+
+    if (level > s.bestLevel) {
+        s.bestLevel = level;
+        s.bestX = s.pointX;
+        s.bestY = s.pointY;
+    }
+
+    if (s.phase == ACQ_SPIRAL) {
+        int8_t dx = s.pointX - s.centerX;
+        int8_t dy = s.pointY - s.centerY;
+        if (dy == 0 && dx == 1)  s.neighbors[0] = level;
+        if (dy == 0 && dx == -1) s.neighbors[1] = level;
+        if (dx == 0 && dy == 1)  s.neighbors[2] = level;
+        if (dx == 0 && dy == -1) s.neighbors[3] = level;
+    }
+
+    advance(s);
+}
+
+// ══════════════════════════════════════════════════════════════
+// ВРЕМЯ ПЕРЕКЛАДКИ ПРИВОДОВ
+// ══════════════════════════════════════════════════════════════
+uint16_t acqDwellMs(int8_t fromX, int8_t fromY, int8_t toX, int8_t toY) {
+    uint8_t dx = abs(toX - fromX);
+    uint8_t dy = abs(toY - fromY);
+    uint8_t d = dx > dy ? dx : dy;
+    return ACQ_DWELL_BASE_MS + ACQ_DWELL_PER_DEG_MS * d;
+}
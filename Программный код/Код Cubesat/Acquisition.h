@@ -0,0 +1,67 @@
+// Acquisition.h
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdint.h>
+
+// ══════════════════════════════════════════════════════════════
+// ПАРАМЕТРЫ ПОИСКА ЦЕЛИ
+// ══════════════════════════════════════════════════════════════
+// Логика поиска не зависит от Arduino: тот же код собирается
+// на ПК в стенде «Код ПК/acquisition_bench.cpp».
+#define ACQ_FIELD_MIN        -40   // граница поля обзора, °
+#define ACQ_FIELD_MAX         40
+#define ACQ_COARSE_STEP       20   // шаг грубой сетки (5×5 точек), °
+#define ACQ_FINE_STEP_MIN      5   // последний шаг уточняющих сеток 3×3, °
+#define ACQ_SPIRAL_RADIUS      2   // радиус первого витка спирали (шаг 1°)
+#define ACQ_SPIRAL_PASSES      4   // максимум проходов спирали
+
+#define ACQ_DETECT_LEVEL      40   // минимальный отклик цели (отсчёты АЦП)
+#define ACQ_HOLD_LOSS_DIV      2   // срыв: отклик ниже пика / 2 ...
+#define ACQ_HOLD_LOSS_COUNT    3   // ... несколько отсчётов подряд
+
+#define ACQ_DWELL_BASE_MS     60   // успокоение привода после перемещения
+#define ACQ_DWELL_PER_DEG_MS   3   // время перекладки на 1°
+#define ACQ_HOLD_PERIOD_MS   100   // период контроля в режиме удержания
+
+// ══════════════════════════════════════════════════════════════
+// ФАЗЫ ПОИСКА
+// ══════════════════════════════════════════════════════════════
+enum AcqPhase {
+    ACQ_COARSE = 0,   // грубая сетка по всему полю
+    ACQ_REFINE = 1,   // иерархические сетки 3×3 вокруг максимума
+    ACQ_SPIRAL = 2,   // спираль с шагом 1°
+    ACQ_HOLD   = 3,   // удержание на пике
+    ACQ_FAILED = 4    // цель не найдена
+};
+
+// ══════════════════════════════════════════════════════════════
+// СОСТОЯНИЕ ПОИСКА
+// ══════════════════════════════════════════════════════════════
+struct AcqSearch {
+    AcqPhase phase;
+    int8_t centerX;         // центр текущей сетки / спирали
+    int8_t centerY;
+    uint8_t gridStep;       // шаг текущей сетки, °
+    uint8_t index;          // номер точки внутри сетки / спирали
+    uint8_t spiralPoints;   // длина текущего прохода спирали
+    uint8_t spiralPass;     // номер прохода спирали
+    int8_t pointX;          // точка, для которой ожидается отсчёт
+    int8_t pointY;
+    int8_t bestX;           // лучшая точка
+    int8_t bestY;
+    uint16_t bestLevel;
+    uint16_t neighbors[4];  // отклик в (+1,0), (-1,0), (0,+1), (0,-1) от пика
+    uint8_t lossCount;      // подряд слабых отсчётов в удержании
+    uint8_t errorTenths;    // оценка ошибки наведения при захвате, 0.1° (0xFF — нет)
+    uint16_t points;        // всего измерено точек
+};
+
+// ══════════════════════════════════════════════════════════════
+// ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+void acqStart(AcqSearch &s);
+void acqFeed(AcqSearch &s, uint16_t level);
+uint16_t acqDwellMs(int8_t fromX, int8_t fromY, int8_t toX, int8_t toY);
+
+#endif
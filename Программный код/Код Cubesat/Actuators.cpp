@@ -3,6 +3,7 @@
 #include <Servo.h>
 #include "Data_Structures.h"
 #include "Actuators.h"
+#include "Storage.h"
 
 
 // ══════════════════════════════════════════════════════════════
@@ -34,10 +35,10 @@ void actuatorsSetup() {
     pinMode(EMERGENCY_BTN, INPUT_PULLUP);
     attachInterrupt(digitalPinToInterrupt(EMERGENCY_BTN), emergencyButtonISR, FALLING);
     
-    servoX.writeMicroseconds(SERVO_X_CENTER);
-    servoY.writeMicroseconds(SERVO_Y_CENTER);
-    currentAngleX = 0;
-    currentAngleY = 0;
+    // Углы восстановлены из EEPROM до вызова (иначе 0°): привод не
+    // дёргается в центр и обратно
+    servoX.writeMicroseconds(angleToPWM(currentAngleX, config.servoXMinUs, config.servoXMaxUs));
+    servoY.writeMicroseconds(angleToPWM(currentAngleY, config.servoYMinUs, config.servoYMaxUs));
     
     statusMask = STATUS_PACKET_LEN_OK | STATUS_CRC_OK;
     
@@ -64,8 +65,9 @@ int8_t pwmToAngle(uint16_t pwm, int16_t min_us, int16_t max_us) {
 // ОБНОВЛЕНИЕ ПОЗИЦИИ ПО УГЛАМ
 // ══════════════════════════════════════════════════════════════
 void updatePositionX(int8_t angle) {
+    if (!servoState) setServo(true);
     currentAngleX = angle;
-    uint16_t pwm = angleToPWM(angle, SERVO_X_MIN_US, SERVO_X_MAX_US);
+    uint16_t pwm = angleToPWM(angle, config.servoXMinUs, config.servoXMaxUs);
     servoX.writeMicroseconds(pwm);
     statusMask &= ~STATUS_PWM_X_MODE;
     
@@ -75,8 +77,9 @@ void updatePositionX(int8_t angle) {
 }
 
 void updatePositionY(int8_t angle) {
+    if (!servoState) setServo(true);
     currentAngleY = angle;
-    uint16_t pwm = angleToPWM(angle, SERVO_Y_MIN_US, SERVO_Y_MAX_US);
+    uint16_t pwm = angleToPWM(angle, config.servoYMinUs, config.servoYMaxUs);
     servoY.writeMicroseconds(pwm);
     statusMask &= ~STATUS_PWM_Y_MODE;
     
@@ -94,8 +97,9 @@ void updatePositionXY(int8_t x, int8_t y) {
 // ОБНОВЛЕНИЕ ШИМ НАПРЯМУЮ
 // ══════════════════════════════════════════════════════════════
 void updatePWM_X(uint16_t pwm) {
+    if (!servoState) setServo(true);
     servoX.writeMicroseconds(pwm);
-    currentAngleX = pwmToAngle(pwm, SERVO_X_MIN_US, SERVO_X_MAX_US);
+    currentAngleX = pwmToAngle(pwm, config.servoXMinUs, config.servoXMaxUs);
     statusMask |= STATUS_PWM_X_MODE;
     
     Serial.print(F("[Actuators] X PWM → "));
@@ -106,8 +110,9 @@ void updatePWM_X(uint16_t pwm) {
 }
 
 void updatePWM_Y(uint16_t pwm) {
+    if (!servoState) setServo(true);
     servoY.writeMicroseconds(pwm);
-    currentAngleY = pwmToAngle(pwm, SERVO_Y_MIN_US, SERVO_Y_MAX_US);
+    currentAngleY = pwmToAngle(pwm, config.servoYMinUs, config.servoYMaxUs);
     statusMask |= STATUS_PWM_Y_MODE;
     
     Serial.print(F("[Actuators] Y PWM → "));
@@ -139,12 +144,20 @@ void setLaser(bool state) {
     Serial.println(state ? F("ON") : F("OFF"));
 }
 
+// Отключённый привод не получает импульсов и не держит положение —
+// в IDLE и во сне это основная экономия по приводам
 void setServo(bool state) {
     servoState = state;
     
     if (state) {
+        servoX.attach(SERVO_X_PIN);
+        servoY.attach(SERVO_Y_PIN);
+        servoX.writeMicroseconds(angleToPWM(currentAngleX, config.servoXMinUs, config.servoXMaxUs));
+        servoY.writeMicroseconds(angleToPWM(currentAngleY, config.servoYMinUs, config.servoYMaxUs));
         statusMask |= STATUS_PWR_SERVO;
     } else {
+        servoX.detach();
+        servoY.detach();
         statusMask &= ~STATUS_PWR_SERVO;
     }
     
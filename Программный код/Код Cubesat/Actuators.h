@@ -15,6 +15,7 @@
 // ══════════════════════════════════════════════════════════════
 // КАЛИБРОВКА СЕРВОПРИВОВ (µs)
 // ══════════════════════════════════════════════════════════════
+// Значения прошивки; рабочая калибровка — в config (Storage.h)
 #define SERVO_X_MIN_US  1000   // -40°
 #define SERVO_X_MAX_US  2000   // +40°
 #define SERVO_X_CENTER  1500   // 0°
@@ -36,6 +37,7 @@ extern int8_t currentAngleY;
 extern bool laserState;
 extern bool servoState;
 extern uint8_t statusMask;
+extern volatile bool emergencyPressed;
 
 // ══════════════════════════════════════════════════════════════
 // ФУНКЦИИ
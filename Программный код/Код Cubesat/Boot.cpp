@@ -0,0 +1,73 @@
+// Boot.cpp
+#include <Arduino.h>
+#include "Boot.h"
+
+
+// ══════════════════════════════════════════════════════════════
+// ПРИЧИНА СБРОСА
+// ══════════════════════════════════════════════════════════════
+// Optiboot обнуляет MCUSR до запуска скетча и передаёт его значение в r2:
+// регистр сохраняется в .init0, до инициализации C-окружения
+static uint8_t optibootFlags __attribute__((section(".noinit")));
+
+void saveOptibootFlags() __attribute__((naked, used, section(".init0")));
+void saveOptibootFlags() {
+    __asm__ __volatile__("sts %0, r2\n" : "=m"(optibootFlags) :);
+}
+
+static uint8_t resetFlags = 0;
+static bool resetFlagsRead = false;
+
+// Без загрузчика флаги остаются в MCUSR
+uint8_t bootResetFlags() {
+    if (!resetFlagsRead) {
+        resetFlags = MCUSR ? MCUSR : optibootFlags;
+        MCUSR = 0;
+        resetFlagsRead = true;
+    }
+    return resetFlags;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ОТМЕТКИ ЭТАПОВ
+// ══════════════════════════════════════════════════════════════
+static const __FlashStringHelper *markStage[BOOT_MARKS];
+static uint32_t markUs[BOOT_MARKS];
+static uint8_t markCount = 0;
+
+void bootMark(const __FlashStringHelper *stage) {
+    if (markCount >= BOOT_MARKS) return;
+    markStage[markCount] = stage;
+    markUs[markCount] = micros();
+    markCount++;
+}
+
+uint32_t bootElapsedUs() {
+    return markCount ? markUs[markCount - 1] : 0;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ДИАГНОСТИКА
+// ══════════════════════════════════════════════════════════════
+void printBootReport() {
+    Serial.println(F("\n[Boot]"));
+    Serial.print(F("  Reset:"));
+    if (resetFlags & _BV(PORF)) Serial.print(F(" power-on"));
+    if (resetFlags & _BV(EXTRF)) Serial.print(F(" external"));
+    if (resetFlags & _BV(BORF)) Serial.print(F(" brown-out"));
+    if (resetFlags & _BV(WDRF)) Serial.print(F(" watchdog"));
+    if (!(resetFlags & (_BV(PORF) | _BV(EXTRF) | _BV(BORF) | _BV(WDRF)))) Serial.print(F(" unknown"));
+    Serial.println();
+
+    uint32_t prevUs = 0;
+    for (uint8_t i = 0; i < markCount; i++) {
+        Serial.print(F("  "));
+        Serial.print(markStage[i]);
+        Serial.print(F(": +"));
+        Serial.print((markUs[i] - prevUs) / 1000.0, 1);
+        Serial.print(F(" ms (at "));
+        Serial.print(markUs[i] / 1000.0, 1);
+        Serial.println(F(" ms)"));
+        prevUs = markUs[i];
+    }
+}
@@ -0,0 +1,25 @@
+// Boot.h
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+class __FlashStringHelper;
+
+// ══════════════════════════════════════════════════════════════
+// ПАРАМЕТРЫ
+// ══════════════════════════════════════════════════════════════
+// Отметки этапов setup(): время от сброса по micros(). Загрузчик
+// (Optiboot) ждёт скетч только после внешнего сброса — после включения
+// питания и провала напряжения скетч стартует сразу.
+#define BOOT_MARKS 8
+
+// ══════════════════════════════════════════════════════════════
+// ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+uint8_t bootResetFlags();
+void bootMark(const __FlashStringHelper *stage);
+uint32_t bootElapsedUs();
+void printBootReport();
+
+#endif
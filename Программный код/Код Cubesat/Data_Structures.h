@@ -13,6 +13,39 @@
 #define STATUS_PWM_Y_MODE    (1 << 3)  // 0x08 — Y: 1=ШИМ, 0=угол
 #define STATUS_PACKET_LEN_OK (1 << 4)  // 0x10 — корректная длина пакета
 #define STATUS_CRC_OK        (1 << 5)  // 0x20 — корректная CRC
+#define STATUS_SLEEP         (1 << 6)  // 0x40 — КС засыпает, приём по расписанию
+#define STATUS_BOOT          (1 << 7)  // 0x80 — первая доставленная телеметрия после сброса
+
+// ════════════════════════════════════════════════════════════
+// ИДЕНТИФИКАТОРЫ ПАКЕТОВ И РЕЗУЛЬТАТ ПРОВЕРКИ
+// ════════════════════════════════════════════════════════════
+#define PACKET_HEADER_CMD    0x37
+#define PACKET_HEADER_TELEM  0x38
+#define PACKET_SAT_ID        0x25
+
+#define PACKET_OK            0
+#define PACKET_BAD_HEADER    1
+#define PACKET_BAD_SAT_ID    2
+#define PACKET_BAD_CRC       3
+
+// ════════════════════════════════════════════════════════════
+// РАСПИСАНИЕ ПРИЁМА СПЯЩЕЙ КС
+// ════════════════════════════════════════════════════════════
+// Во сне КС включает приёмник на SLEEP_LISTEN_WINDOW_MS после каждых
+// SLEEP_LISTEN_PERIOD_MS ожидания. БС, получив телеметрию с STATUS_SLEEP,
+// повторяет кадр дольше полного цикла — он попадает в одно из окон.
+// Интервалы КС отсчитывает сторожевой таймер (RC-генератор, ±10%).
+#define SLEEP_LISTEN_PERIOD_MS  1000
+#define SLEEP_LISTEN_WINDOW_MS  32
+
+// ════════════════════════════════════════════════════════════
+// КЛЮЧИ КОНФИГУРАЦИИ (поле cfg_key пакета команд)
+// ════════════════════════════════════════════════════════════
+// КС сохраняет конфигурацию в EEPROM, она переживает сброс.
+#define CFG_NONE             0xFF
+#define CFG_SERVO_X          1     // калибровка X: cfg_value — ШИМ при -40°, cfg_value2 — при +40°
+#define CFG_SERVO_Y          2     // калибровка Y
+#define CFG_DEFAULTS         3     // сброс конфигурации к значениям прошивки
 
 // ════════════════════════════════════════════════════════════
 // ФУНКЦИИ ПРЕОБРАЗОВАНИЯ УГЛОВ
@@ -29,13 +62,15 @@ inline int8_t nrfToAngle(uint8_t nrf_angle) {
 }
 
 // ════════════════════════════════════════════════════════════
-// ФУНКЦИИ РАСЧЁТА CRC16 (CCITT-FALSE)
+// ФУНКЦИИ РАСЧЁТА CRC16 (полином 0x1021, начальное значение 0 — XMODEM)
 // ════════════════════════════════════════════════════════════
+// Старший бит проверяется до сдвига: после сдвига в uint16_t
+// бит 16 уже потерян, и полином никогда не применялся бы
 inline uint16_t crc16_ccitt_update(uint16_t crc, uint8_t data) {
     crc ^= ((uint16_t)data) << 8;
     for (uint8_t i = 0; i < 8; i++) {
-        crc <<= 1;
-        if (crc & 0x10000) crc ^= 0x1021;
+        if (crc & 0x8000) crc = (crc << 1) ^ 0x1021;
+        else crc <<= 1;
     }
     return crc;
 }
@@ -48,24 +83,49 @@ inline uint16_t calculateCRC16(const uint8_t* data, uint8_t length) {
     return crc;
 }
 
+// CRC пакета (24 байта) считается с обнулённым полем crc в конце
+inline uint16_t packetCRC16(const uint8_t* raw) {
+    uint16_t crc = calculateCRC16(raw, 22);
+    crc = crc16_ccitt_update(crc, 0);
+    return crc16_ccitt_update(crc, 0);
+}
+
+// ════════════════════════════════════════════════════════════
+// СОВМЕСТИМОСТЬ С ПРЕЖНЕЙ ПРОШИВКОЙ
+// ════════════════════════════════════════════════════════════
+// Формат эфира несовместим с исходной прошивкой: прежняя функция CRC
+// теряла старший бит и всегда давала 0, а crc пакета команд лежал
+// в байтах 20–21 (теперь 22–23, как в телеметрии). Станции с прежней
+// и новой прошивкой отбрасывают кадры друг друга — КС и БС
+// прошиваются вместе. Кадр прежней прошивки узнаётся по нулевому crc.
+inline bool packetLegacyCRC(const uint8_t* raw) {
+    return raw[22] == 0 && raw[23] == 0 && packetCRC16(raw) != 0;
+}
+
 // ════════════════════════════════════════════════════════════
 // ПАКЕТ КОМАНД БС → КС (24 байта)
 // ════════════════════════════════════════════════════════════
+// Поля упакованы без выравнивания — раскладка совпадает с эфиром
+// и при сборке на ПК (симуляторы и обработка архивов).
 union NRF_BS2CS {
-    struct {
+    struct __attribute__((packed)) {
         uint8_t header;        // 0x37 — заголовок пакета команд
         uint8_t sat_id;        // 0x25 — ID спутника
         uint8_t packet_num;    // циклический номер пакета
         uint8_t script;        // скрипт/режим (0xFF = не менять)
-        uint8_t time_step;     // период шага (0xFF = не менять)
-        uint8_t time_telem;    // период телеметрии (0xFF = не менять)
+        uint8_t time_step;     // период шага, ×10 мс (0xFF = не менять)
+        uint8_t time_telem;    // период телеметрии, ×100 мс, 0 = только по событиям (0xFF = не менять)
         uint8_t pwr_servo;     // управление сервом (0xFF = не менять)
         uint8_t pwr_laser;     // управление лазером (0xFF = не менять)
         uint16_t pwm_x;        // ШИМ X (500–2500 µs, 0xFFFF = не менять)
         uint16_t pwm_y;        // ШИМ Y (500–2500 µs, 0xFFFF = не менять)
         uint8_t pos_x;         // угол X (0...80, где 40 = 0°, 0xFF = не менять)
         uint8_t pos_y;         // угол Y (0...80, где 40 = 0°, 0xFF = не менять)
-        uint8_t reserved[6];   // резерв
+        uint8_t cfg_key;       // параметр конфигурации CFG_* (0xFF = нет)
+        uint16_t cfg_value;    // значение параметра
+        uint16_t cfg_value2;   // второе значение (верхняя граница)
+        uint8_t session;       // сеанс БС: случайный номер, новый при каждом запуске
+        uint8_t reserved[2];   // резерв
         uint16_t crc;          // CRC16-CCITT
     } fields;
     uint8_t raw[24];
@@ -75,14 +135,14 @@ union NRF_BS2CS {
 // ПАКЕТ ТЕЛЕМЕТРИИ КС → БС (24 байта)
 // ════════════════════════════════════════════════════════════
 union NRF_CS2BS {
-    struct {
+    struct __attribute__((packed)) {
         uint8_t header;        // 0x38 — заголовок пакета телеметрии
         uint8_t sat_id;        // 0x25 — ID спутника
         uint8_t packet_num;    // номер пакета телеметрии
         uint8_t last_cmd_num;  // номер последнего принятого пакета команд
         uint32_t timestamp;    // время в мс (millis())
         uint8_t status;        // БИТОВАЯ МАСКА (STATUS_*)
-        uint8_t mode;          // 0=Idle, 1=Horiz, 2=Vert, 3=Diag1, 4=Diag2
+        uint8_t mode;          // 0=Idle, 1=Horiz, 2=Vert, 3=Diag1, 4=Diag2, 5=Manual, 6=Acquire
         uint8_t script_step;   // текущий шаг скрипта
         uint16_t pwm_x;        // фактический ШИМ X
         uint16_t pwm_y;        // фактический ШИМ Y
@@ -90,10 +150,47 @@ union NRF_CS2BS {
         int8_t pos_y;          // фактический угол Y
         uint8_t pwr_laser;     // состояние лазера
         uint8_t pwr_servo;     // состояние сервопривода
-        uint8_t reserved[3];   // резерв
+        uint16_t acq_time;     // время захвата цели, ×10 мс (0 = нет захвата)
+        uint8_t acq_error;     // оценка ошибки наведения, ×0.1° (0xFF = нет)
         uint16_t crc;          // CRC16-CCITT
     } fields;
     uint8_t raw[24];
 };
 
+// packetCRC16() считает crc последними двумя байтами кадра
+static_assert(sizeof(((NRF_BS2CS *)0)->fields) == 24, "NRF_BS2CS must be 24 bytes");
+static_assert(sizeof(((NRF_CS2BS *)0)->fields) == 24, "NRF_CS2BS must be 24 bytes");
+
+// ════════════════════════════════════════════════════════════
+// СБОРКА И ПРОВЕРКА ПАКЕТОВ
+// ════════════════════════════════════════════════════════════
+// Общие для прошивок и симулятора канала («Код ПК/link_sim.cpp»).
+inline void sealCommandPacket(NRF_BS2CS &p, uint8_t packet_num) {
+    p.fields.header = PACKET_HEADER_CMD;
+    p.fields.sat_id = PACKET_SAT_ID;
+    p.fields.packet_num = packet_num;
+    p.fields.crc = packetCRC16(p.raw);
+}
+
+inline void sealTelemetryPacket(NRF_CS2BS &p, uint8_t packet_num) {
+    p.fields.header = PACKET_HEADER_TELEM;
+    p.fields.sat_id = PACKET_SAT_ID;
+    p.fields.packet_num = packet_num;
+    p.fields.crc = packetCRC16(p.raw);
+}
+
+inline uint8_t checkCommandPacket(const NRF_BS2CS &p) {
+    if (p.fields.header != PACKET_HEADER_CMD) return PACKET_BAD_HEADER;
+    if (p.fields.sat_id != PACKET_SAT_ID) return PACKET_BAD_SAT_ID;
+    if (p.fields.crc != packetCRC16(p.raw)) return PACKET_BAD_CRC;
+    return PACKET_OK;
+}
+
+inline uint8_t checkTelemetryPacket(const NRF_CS2BS &p) {
+    if (p.fields.header != PACKET_HEADER_TELEM) return PACKET_BAD_HEADER;
+    if (p.fields.sat_id != PACKET_SAT_ID) return PACKET_BAD_SAT_ID;
+    if (p.fields.crc != packetCRC16(p.raw)) return PACKET_BAD_CRC;
+    return PACKET_OK;
+}
+
 #endif
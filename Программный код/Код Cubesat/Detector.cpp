@@ -0,0 +1,43 @@
+// Detector.cpp
+#include <Arduino.h>
+#include "Data_Structures.h"
+#include "Actuators.h"
+#include "Detector.h"
+
+
+// ══════════════════════════════════════════════════════════════
+// ИНИЦИАЛИЗАЦИЯ
+// ══════════════════════════════════════════════════════════════
+void detectorSetup() {
+    pinMode(DETECTOR_PIN, INPUT);
+    analogRead(DETECTOR_PIN);  // первый отсчёт после переключения мультиплексора отбрасываем
+
+    Serial.println(F("[Detector] Initialized ✓"));
+}
+
+// ══════════════════════════════════════════════════════════════
+// ИЗМЕРЕНИЕ ОТРАЖЁННОГО СИГНАЛА
+// ══════════════════════════════════════════════════════════════
+// Отсчёт берётся дважды — с включённым и выключенным лазером;
+// разность не зависит от фоновой засветки.
+static uint16_t sampleDetector() {
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < DETECTOR_SAMPLES; i++) {
+        sum += analogRead(DETECTOR_PIN);
+    }
+    return sum / DETECTOR_SAMPLES;
+}
+
+uint16_t readDetector() {
+    digitalWrite(LASER_PIN, HIGH);
+    delayMicroseconds(200);
+    uint16_t lit = sampleDetector();
+
+    digitalWrite(LASER_PIN, LOW);
+    delayMicroseconds(200);
+    uint16_t dark = sampleDetector();
+
+    digitalWrite(LASER_PIN, laserState ? HIGH : LOW);
+
+    return (lit > dark) ? (lit - dark) : 0;
+}
@@ -0,0 +1,19 @@
+// Detector.h
+#ifndef DETECTOR_H
+#define DETECTOR_H
+
+#include <stdint.h>
+
+// ══════════════════════════════════════════════════════════════
+// ФОТОПРИЁМНИК
+// ══════════════════════════════════════════════════════════════
+#define DETECTOR_PIN       A0    // аналоговый выход фотодиода
+#define DETECTOR_SAMPLES   8     // отсчётов АЦП на одно измерение
+
+// ══════════════════════════════════════════════════════════════
+// ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+void detectorSetup();
+uint16_t readDetector();
+
+#endif
@@ -0,0 +1,274 @@
+// Power.cpp
+#include <Arduino.h>
+#include <RF24.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include "Data_Structures.h"
+#include "Actuators.h"
+#include "Power.h"
+
+
+// ══════════════════════════════════════════════════════════════
+// ГЛОБАЛЬНЫЕ ПЕРЕМЕННЫЕ
+// ══════════════════════════════════════════════════════════════
+PowerBudget powerBudget;
+
+static RF24 *powerRadio = 0;
+static uint8_t powerCePin = 0;
+
+static uint32_t accountedMs = 0;      // millis(), до которого время учтено
+static uint32_t lastActivityMs = 0;
+static uint32_t wakeMs = 0;
+static bool wakePending = false;      // ждём первую команду после пробуждения
+static uint16_t sleepCount = 0;
+static uint32_t lastWakeLatency = 0;
+
+static volatile bool radioWake = false;
+
+// Счётчик millis() ядра Arduino (wiring.c)
+extern volatile unsigned long timer0_millis;
+
+// Названия режимов для отчёта — во флеше, как и строки F()
+static const char POWER_NAME_RUN[] PROGMEM = "run";
+static const char POWER_NAME_IDLE[] PROGMEM = "idle";
+static const char POWER_NAME_LISTEN[] PROGMEM = "listen";
+static const char POWER_NAME_STANDBY[] PROGMEM = "standby";
+static const char *const POWER_MODE_NAMES[PWR_MODES] PROGMEM = {
+    POWER_NAME_RUN, POWER_NAME_IDLE, POWER_NAME_LISTEN, POWER_NAME_STANDBY
+};
+
+// Номинальные периоды WDT для WDTO_15MS … WDTO_8S, мс
+static const uint16_t WDT_PERIOD_MS[10] = {16, 32, 64, 125, 250, 500, 1000, 2000, 4000, 8000};
+
+// ══════════════════════════════════════════════════════════════
+// ПРЕРЫВАНИЯ ПРОБУЖДЕНИЯ
+// ══════════════════════════════════════════════════════════════
+ISR(WDT_vect) {
+    // Только пробуждение: интервал отсчитан
+}
+
+ISR(PCINT0_vect) {
+    if (digitalRead(RF24_IRQ_PIN) == LOW) radioWake = true;
+}
+
+ISR(PCINT2_vect) {
+    if (digitalRead(EMERGENCY_BTN) == LOW) emergencyPressed = true;
+}
+
+static void enablePinWake(uint8_t pin, bool enable) {
+    if (enable) {
+        *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+        *digitalPinToPCICR(pin) |= _BV(digitalPinToPCICRbit(pin));
+    } else {
+        *digitalPinToPCMSK(pin) &= ~_BV(digitalPinToPCMSKbit(pin));
+        if (*digitalPinToPCMSK(pin) == 0) *digitalPinToPCICR(pin) &= ~_BV(digitalPinToPCICRbit(pin));
+    }
+}
+
+// ══════════════════════════════════════════════════════════════
+// ИНИЦИАЛИЗАЦИЯ
+// ══════════════════════════════════════════════════════════════
+void powerSetup(RF24 &radio, uint8_t cePin) {
+    powerRadio = &radio;
+    powerCePin = cePin;
+    pinMode(RF24_IRQ_PIN, INPUT);
+
+    // IRQ только по приёму: TX_DS и MAX_RT опрашиваются библиотекой
+    radio.maskIRQ(true, true, false);
+
+    powerBudgetReset(powerBudget);
+    accountedMs = millis();
+    lastActivityMs = accountedMs;
+
+    Serial.println(F("[Power] Initialized ✓"));
+}
+
+// ══════════════════════════════════════════════════════════════
+// УЧЁТ ВРЕМЕНИ БОДРСТВОВАНИЯ
+// ══════════════════════════════════════════════════════════════
+static void accountAwake(PowerMode mode) {
+    uint32_t now = millis();
+    powerBudgetAdd(powerBudget, mode, now - accountedMs, servoState, laserState);
+    accountedMs = now;
+}
+
+// Пауза loop(): МК спит в SLEEP_MODE_IDLE, будит любое прерывание
+// (Timer0 — раз в 1 мс, Servo, UART, кнопка)
+void powerDelay(uint16_t ms) {
+    accountAwake(PWR_RUN);
+
+    uint32_t start = millis();
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (millis() - start < ms) {
+        sleep_mode();
+    }
+
+    accountAwake(PWR_IDLE);
+}
+
+// ══════════════════════════════════════════════════════════════
+// ТАЙМЕР ПРОСТОЯ
+// ══════════════════════════════════════════════════════════════
+// Сон откладывают только команды с изменениями: опрос БС
+// (все поля «не менять») не должен держать КС в бодрствовании.
+void powerActivity() {
+    lastActivityMs = millis();
+}
+
+bool powerIdleExpired(bool busy) {
+    uint32_t now = millis();
+    if (busy) lastActivityMs = now;
+    return now - lastActivityMs >= POWER_IDLE_TIMEOUT_MS;
+}
+
+// ══════════════════════════════════════════════════════════════
+// СОН ПО РАСПИСАНИЮ
+// ══════════════════════════════════════════════════════════════
+static bool wakeRequested() {
+    return radioWake || emergencyPressed;
+}
+
+// Timer0 во сне стоит: без поправки millis() отставал бы на всё время
+// сна — отметка времени телеметрии, таймер простоя и периоды loop()
+// считались бы только по бодрствованию. micros() не догоняется.
+static void advanceMillis(uint16_t ms) {
+    uint8_t sreg = SREG;
+    cli();
+    timer0_millis += ms;
+    SREG = sreg;
+}
+
+// SLEEP_MODE_PWR_DOWN на ms, шагами WDT. false — разбудило прерывание.
+// Время учитывается и добавляется к millis() по номиналу WDT (шаг,
+// прерванный IRQ, засчитывается целиком — оценка сверху; сам WDT
+// уходит на ±10%).
+static bool sleepFor(uint16_t ms, PowerMode mode) {
+    while (ms >= WDT_PERIOD_MS[0]) {
+        uint8_t p = 9;
+        while (WDT_PERIOD_MS[p] > ms) p--;
+
+        cli();
+        if (wakeRequested()) {
+            sei();
+            return false;
+        }
+        MCUSR &= ~_BV(WDRF);
+        WDTCSR = _BV(WDCE) | _BV(WDE);
+        WDTCSR = _BV(WDIE) | (p & 0x07) | ((p & 0x08) ? _BV(WDP3) : 0);
+        wdt_reset();
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        sleep_enable();
+        sleep_bod_disable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        wdt_disable();
+
+        powerBudgetAdd(powerBudget, mode, WDT_PERIOD_MS[p], false, false);
+        advanceMillis(WDT_PERIOD_MS[p]);
+        ms -= WDT_PERIOD_MS[p];
+        if (wakeRequested()) return false;
+    }
+    return true;
+}
+
+// Приводы отключаются, модуль между окнами ждёт в Standby-I (CE = 0),
+// в окне — принимает; кадр БС подтверждается аппаратно и будит МК по IRQ.
+void powerSleep() {
+    if (servoState) setServo(false);
+
+    Serial.print(F("[Power] Sleep: RX "));
+    Serial.print(SLEEP_LISTEN_WINDOW_MS);
+    Serial.print(F(" ms every "));
+    Serial.print(SLEEP_LISTEN_PERIOD_MS + SLEEP_LISTEN_WINDOW_MS);
+    Serial.println(F(" ms"));
+    printPowerReport();
+    Serial.flush();
+    accountAwake(PWR_RUN);
+
+    // Флаги модуля сбрасываются, чтобы следующий приём дал фронт IRQ
+    bool txOk, txFail, rxReady;
+    powerRadio->whatHappened(txOk, txFail, rxReady);
+    radioWake = powerRadio->available();
+
+    uint8_t adc = ADCSRA;
+    ADCSRA &= ~_BV(ADEN);
+    enablePinWake(RF24_IRQ_PIN, true);
+    enablePinWake(EMERGENCY_BTN, true);
+
+    uint16_t windows = 0;
+    for (;;) {
+        digitalWrite(powerCePin, LOW);
+        if (!sleepFor(SLEEP_LISTEN_PERIOD_MS, PWR_STANDBY)) break;
+        digitalWrite(powerCePin, HIGH);
+        windows++;
+        if (!sleepFor(SLEEP_LISTEN_WINDOW_MS, PWR_LISTEN)) break;
+    }
+    digitalWrite(powerCePin, HIGH);
+
+    enablePinWake(RF24_IRQ_PIN, false);
+    enablePinWake(EMERGENCY_BTN, false);
+    ADCSRA = adc;
+
+    wakeMs = millis();
+    accountedMs = wakeMs;
+    lastActivityMs = wakeMs;
+    sleepCount++;
+    wakePending = radioWake;
+    radioWake = false;
+
+    Serial.print(F("[Power] Woke by "));
+    Serial.print(wakePending ? F("radio") : F("emergency button"));
+    Serial.print(F(" after "));
+    Serial.print(windows);
+    Serial.println(F(" RX windows"));
+}
+
+// Задержка от пробуждения до разбора команды, которая разбудила КС
+void powerCommandReceived() {
+    if (!wakePending) return;
+    wakePending = false;
+    lastWakeLatency = millis() - wakeMs;
+
+    Serial.print(F("[Power] Wake → command: "));
+    Serial.print(lastWakeLatency);
+    Serial.println(F(" ms"));
+}
+
+// ══════════════════════════════════════════════════════════════
+// ДИАГНОСТИКА
+// ══════════════════════════════════════════════════════════════
+void printPowerReport() {
+    accountAwake(PWR_RUN);
+    uint32_t total = powerBudgetTotalMs(powerBudget);
+    uint32_t meanUA = powerMeanCurrentUA(powerBudget);
+
+    Serial.println(F("\n[Power Budget]"));
+    Serial.print(F("  Accounted: "));
+    Serial.print(total / 1000.0, 1);
+    Serial.println(F(" s"));
+    for (uint8_t m = 0; m < PWR_MODES; m++) {
+        Serial.print(F("  "));
+        Serial.print((const __FlashStringHelper *)pgm_read_ptr(&POWER_MODE_NAMES[m]));
+        Serial.print(F(": "));
+        Serial.print(total ? powerBudget.modeMs[m] * 100.0 / total : 0.0, 1);
+        Serial.println(F("%"));
+    }
+    Serial.print(F("  Servo hold: "));
+    Serial.print(total ? powerBudget.servoMs * 100.0 / total : 0.0, 1);
+    Serial.println(F("%"));
+    Serial.print(F("  Mean current: "));
+    Serial.print(meanUA / 1000.0, 2);
+    Serial.print(F(" mA → "));
+    Serial.print(meanUA / 1000.0, 2);
+    Serial.print(F(" mAh/h, "));
+    Serial.print(powerEnergyPerHourMWh(meanUA), 1);
+    Serial.println(F(" mWh/h"));
+    Serial.print(F("  Sleeps: "));
+    Serial.print(sleepCount);
+    Serial.print(F(" | last wake → command: "));
+    Serial.print(lastWakeLatency);
+    Serial.println(F(" ms"));
+    Serial.println();
+}
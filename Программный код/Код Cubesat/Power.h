@@ -0,0 +1,35 @@
+// Power.h
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include "PowerBudget.h"
+
+class RF24;
+
+// ══════════════════════════════════════════════════════════════
+// ПИНЫ И ПАРАМЕТРЫ
+// ══════════════════════════════════════════════════════════════
+// INT0 занят кнопкой, INT1 (D3) — приводом X: IRQ модуля заведён
+// на прерывание по изменению уровня (PCINT0). Во сне кнопка тоже
+// будит через PCINT — фронт на INT0 без тактирования не ловится.
+#define RF24_IRQ_PIN          8       // IRQ nRF24L01+ (ACTIVE LOW)
+#define POWER_IDLE_TIMEOUT_MS 30000   // бездействие в IDLE до перехода в сон
+
+// ══════════════════════════════════════════════════════════════
+// ЭКСТЕРНЫЕ ГЛОБАЛЬНЫЕ ПЕРЕМЕННЫЕ
+// ══════════════════════════════════════════════════════════════
+extern PowerBudget powerBudget;
+
+// ══════════════════════════════════════════════════════════════
+// ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+void powerSetup(RF24 &radio, uint8_t cePin);
+void powerActivity();
+bool powerIdleExpired(bool busy);
+void powerSleep();                  // millis() продолжает идти по WDT (±10%)
+void powerCommandReceived();
+void powerDelay(uint16_t ms);
+void printPowerReport();
+
+#endif
@@ -0,0 +1,58 @@
+// PowerBudget.cpp
+#include <stdint.h>
+#include "PowerBudget.h"
+
+
+// ══════════════════════════════════════════════════════════════
+// УЧЁТ ВРЕМЕНИ
+// ══════════════════════════════════════════════════════════════
+void powerBudgetReset(PowerBudget &b) {
+    for (uint8_t m = 0; m < PWR_MODES; m++) b.modeMs[m] = 0;
+    b.servoMs = 0;
+    b.laserMs = 0;
+}
+
+void powerBudgetAdd(PowerBudget &b, PowerMode mode, uint32_t ms, bool servo, bool laser) {
+    b.modeMs[mode] += ms;
+    if (servo) b.servoMs += ms;
+    if (laser) b.laserMs += ms;
+}
+
+uint32_t powerBudgetTotalMs(const PowerBudget &b) {
+    uint32_t total = 0;
+    for (uint8_t m = 0; m < PWR_MODES; m++) total += b.modeMs[m];
+    return total;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ТОК И ЭНЕРГИЯ
+// ══════════════════════════════════════════════════════════════
+// Ток режима включает приводы без импульсов; удержание и лазер
+// добавляются по своему времени в powerMeanCurrentUA().
+uint32_t powerModeCurrentUA(PowerMode mode) {
+    uint32_t servos = (uint32_t)POWER_SERVO_COUNT * POWER_SERVO_IDLE_UA;
+    switch (mode) {
+        case PWR_RUN:     return POWER_MCU_RUN_UA + POWER_RADIO_RX_UA + servos;
+        case PWR_IDLE:    return POWER_MCU_IDLE_UA + POWER_RADIO_RX_UA + servos;
+        case PWR_LISTEN:  return POWER_MCU_DOWN_UA + POWER_RADIO_RX_UA + servos;
+        case PWR_STANDBY: return POWER_MCU_DOWN_UA + POWER_RADIO_STANDBY_UA + servos;
+        default:          return 0;
+    }
+}
+
+uint32_t powerMeanCurrentUA(const PowerBudget &b) {
+    uint32_t total = powerBudgetTotalMs(b);
+    if (total == 0) return 0;
+
+    uint64_t charge = 0;  // мкА·мс
+    for (uint8_t m = 0; m < PWR_MODES; m++) {
+        charge += (uint64_t)powerModeCurrentUA((PowerMode)m) * b.modeMs[m];
+    }
+    charge += (uint64_t)POWER_SERVO_COUNT * (POWER_SERVO_HOLD_UA - POWER_SERVO_IDLE_UA) * b.servoMs;
+    charge += (uint64_t)POWER_LASER_UA * b.laserMs;
+    return (uint32_t)(charge / total);
+}
+
+float powerEnergyPerHourMWh(uint32_t meanUA) {
+    return meanUA * (POWER_SUPPLY_MV / 1000.0f) / 1000.0f;
+}
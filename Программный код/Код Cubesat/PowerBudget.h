@@ -0,0 +1,57 @@
+// PowerBudget.h
+#ifndef POWER_BUDGET_H
+#define POWER_BUDGET_H
+
+#include <stdint.h>
+
+// ══════════════════════════════════════════════════════════════
+// ТОКИ ПОТРЕБЛЕНИЯ (мкА)
+// ══════════════════════════════════════════════════════════════
+// Модель не зависит от Arduino: тот же код считает бюджет
+// в симуляторе канала «Код ПК/link_sim.cpp».
+// Типовые значения по документации ATmega328P, nRF24L01+ и SG90.
+// Потери платы (стабилизатор, USB-UART, светодиод) не учитываются.
+#define POWER_MCU_RUN_UA        9000   // ATmega328P, 16 МГц, 5 В
+#define POWER_MCU_IDLE_UA       3500   // SLEEP_MODE_IDLE: таймеры и UART работают
+#define POWER_MCU_DOWN_UA          6   // SLEEP_MODE_PWR_DOWN + WDT, BOD выключен
+#define POWER_RADIO_RX_UA      12600   // nRF24L01+, приём 250 кбит/с
+#define POWER_RADIO_STANDBY_UA    26   // nRF24L01+, Standby-I (CE = 0)
+#define POWER_SERVO_IDLE_UA     3000   // электроника привода без импульсов (оценка)
+#define POWER_SERVO_HOLD_UA    10000   // привод удерживает положение
+#define POWER_SERVO_COUNT          2
+#define POWER_LASER_UA         25000
+#define POWER_SUPPLY_MV         5000
+
+// ══════════════════════════════════════════════════════════════
+// РЕЖИМЫ ПИТАНИЯ
+// ══════════════════════════════════════════════════════════════
+enum PowerMode {
+    PWR_RUN     = 0,   // МК работает, приёмник включён
+    PWR_IDLE    = 1,   // МК в SLEEP_MODE_IDLE между итерациями loop()
+    PWR_LISTEN  = 2,   // МК спит, окно приёма по расписанию
+    PWR_STANDBY = 3,   // МК спит, модуль в Standby-I
+    PWR_MODES   = 4
+};
+
+// ══════════════════════════════════════════════════════════════
+// НАКОПЛЕННОЕ ВРЕМЯ (мс)
+// ══════════════════════════════════════════════════════════════
+struct PowerBudget {
+    uint32_t modeMs[PWR_MODES];
+    uint32_t servoMs;        // приводы под импульсами управления
+    uint32_t laserMs;
+};
+
+// ══════════════════════════════════════════════════════════════
+// ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+void powerBudgetReset(PowerBudget &b);
+void powerBudgetAdd(PowerBudget &b, PowerMode mode, uint32_t ms, bool servo, bool laser);
+uint32_t powerBudgetTotalMs(const PowerBudget &b);
+uint32_t powerModeCurrentUA(PowerMode mode);
+
+// Средний ток за учтённое время, мкА — он же расход в мкА·ч за час
+uint32_t powerMeanCurrentUA(const PowerBudget &b);
+float powerEnergyPerHourMWh(uint32_t meanUA);
+
+#endif
@@ -0,0 +1,248 @@
+// Protocol.h
+// Логика протокола без обращений к Arduino: сборка команд и очередь
+// потоковой передачи БС, фильтр повторов и разбор команд КС.
+// Копии в «Код Cubesat» и «Код БС» совпадают (как Data_Structures.h);
+// симулятор link_sim выполняет этот же код.
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+#include <string.h>
+#include "Data_Structures.h"
+
+// ════════════════════════════════════════════════════════════
+// СБОРКА КОМАНД (БС)
+// ════════════════════════════════════════════════════════════
+// Все поля, кроме переданных, — «не менять» (0xFF). session — номер
+// сеанса БС: номера пакетов после перезапуска БС снова идут с 1.
+inline void buildCommand(NRF_BS2CS &p, uint8_t session, uint8_t packet_num, uint8_t script,
+                         uint8_t pos_x, uint8_t pos_y, uint16_t pwm_x, uint16_t pwm_y) {
+    memset(&p, 0xFF, sizeof(p));
+    p.fields.session = session;
+    p.fields.script = script;
+    p.fields.pos_x = pos_x;
+    p.fields.pos_y = pos_y;
+    p.fields.pwm_x = pwm_x;
+    p.fields.pwm_y = pwm_y;
+    sealCommandPacket(p, packet_num);
+}
+
+inline void buildConfigCommand(NRF_BS2CS &p, uint8_t session, uint8_t packet_num, uint8_t time_step,
+                               uint8_t time_telem, uint8_t key, uint16_t value, uint16_t value2) {
+    memset(&p, 0xFF, sizeof(p));
+    p.fields.session = session;
+    p.fields.time_step = time_step;
+    p.fields.time_telem = time_telem;
+    p.fields.cfg_key = key;
+    p.fields.cfg_value = value;
+    p.fields.cfg_value2 = value2;
+    sealCommandPacket(p, packet_num);
+}
+
+// ════════════════════════════════════════════════════════════
+// ОЧЕРЕДЬ ПОТОКОВОЙ ПЕРЕДАЧИ (БС)
+// ════════════════════════════════════════════════════════════
+// Кадры загружаются writeFast() в FIFO модуля (до 3 в эфире подряд).
+// FIFO выдаёт кадры по порядку, поэтому если он пуст — подтверждены все
+// загруженные, а если не полон — все, кроме последних TX_HW_FIFO - 1.
+#define TX_QUEUE_SIZE     8     // программная очередь команд
+#define TX_HW_FIFO        3     // глубина TX FIFO nRF24L01+
+
+struct TxSlot {
+    NRF_BS2CS packet;
+    uint8_t cmd;
+    bool loaded;            // хотя бы раз загружен в FIFO модуля
+    uint32_t firstLoad;     // millis() первой загрузки
+};
+
+// Первые inFlight кадров от head загружены в FIFO модуля
+struct TxQueue {
+    TxSlot slots[TX_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    uint8_t inFlight;
+};
+
+// Решение по опросу модуля: сколько кадров подтвердить, очистить ли
+// FIFO после MAX_RT и снять ли головной кадр по времени
+struct TxPoll {
+    uint8_t confirm;
+    bool flush;
+    bool dropHead;
+};
+
+inline void txQueueReset(TxQueue &q) {
+    q.head = 0;
+    q.count = 0;
+    q.inFlight = 0;
+}
+
+inline bool txQueuePush(TxQueue &q, const NRF_BS2CS &packet, uint8_t cmd) {
+    if (q.count >= TX_QUEUE_SIZE) return false;
+
+    TxSlot &slot = q.slots[(q.head + q.count) % TX_QUEUE_SIZE];
+    slot.packet = packet;
+    slot.cmd = cmd;
+    slot.loaded = false;
+    q.count++;
+    return true;
+}
+
+inline TxSlot &txQueueHead(TxQueue &q) {
+    return q.slots[q.head];
+}
+
+// Снимает головной кадр; ссылка действительна до следующей txQueuePush()
+inline TxSlot &txQueuePop(TxQueue &q) {
+    TxSlot &slot = q.slots[q.head];
+    q.head = (q.head + 1) % TX_QUEUE_SIZE;
+    q.count--;
+    if (q.inFlight) q.inFlight--;
+    return slot;
+}
+
+// Следующий кадр для загрузки в FIFO (вызывать, пока FIFO не полон), 0 — нет
+inline TxSlot *txQueueLoadNext(TxQueue &q, uint32_t nowMs) {
+    if (q.inFlight >= q.count) return 0;
+
+    TxSlot &slot = q.slots[(q.head + q.inFlight) % TX_QUEUE_SIZE];
+    if (!slot.loaded) {
+        slot.loaded = true;
+        slot.firstLoad = nowMs;
+    }
+    q.inFlight++;
+    return &slot;
+}
+
+// txOk/txFail — TX_DS/MAX_RT из whatHappened() с прошлого опроса.
+// После MAX_RT модуль остановлен на кадре, исчерпавшем ARC; кадры перед
+// ним доставлены, но FIFO_STATUS говорит лишь «полон» (осталось 3) или
+// «не пуст» (1–2): подтверждается нижняя оценка, а txOk добавляет хотя
+// бы один кадр. Неподтверждённые кадры уходят заново, повтор КС
+// отбрасывает по номеру пакета. MAX_RT бывает и от занятой КС (полный
+// RX FIFO), поэтому кадр снимается по времени, а не по числу неудач —
+// и только если именно он остался без подтверждения.
+inline TxPoll txQueuePoll(const TxQueue &q, bool txOk, bool txFail, bool fifoFull, bool fifoEmpty,
+                          uint32_t nowMs, uint32_t timeoutMs) {
+    TxPoll poll = {0, false, false};
+
+    if (txFail) {
+        uint8_t leftMax = fifoFull ? TX_HW_FIFO : TX_HW_FIFO - 1;
+        uint8_t leftMin = fifoFull ? TX_HW_FIFO : 1;
+        poll.confirm = q.inFlight > leftMax ? q.inFlight - leftMax : 0;
+        if (txOk && poll.confirm == 0 && q.inFlight > 1) poll.confirm = 1;
+        poll.flush = true;
+
+        bool headFailed = q.inFlight - poll.confirm <= leftMin;
+        const TxSlot &head = q.slots[(q.head + poll.confirm) % TX_QUEUE_SIZE];
+        poll.dropHead = headFailed && q.count > poll.confirm && nowMs - head.firstLoad > timeoutMs;
+    } else if (fifoEmpty) {
+        poll.confirm = q.inFlight;
+    } else if (!fifoFull && q.inFlight > TX_HW_FIFO - 1) {
+        poll.confirm = q.inFlight - (TX_HW_FIFO - 1);
+    }
+    return poll;
+}
+
+// ════════════════════════════════════════════════════════════
+// ФИЛЬТР ПОВТОРОВ (КС)
+// ════════════════════════════════════════════════════════════
+// Номера последних выполненных команд: БС при потоковой передаче
+// повторяет неподтверждённые кадры, повтор не должен выполняться дважды.
+// Номера действительны только в сеансе БС, выдавшем их: команда из
+// другого сеанса (БС перезапущена) очищает фильтр.
+#define RECENT_COMMANDS 4
+
+struct CommandFilter {
+    uint8_t recent[RECENT_COMMANDS];
+    uint8_t count;
+    uint8_t pos;
+    uint8_t session;
+};
+
+inline void commandFilterReset(CommandFilter &f) {
+    f.count = 0;
+    f.pos = 0;
+}
+
+inline void commandFilterRemember(CommandFilter &f, uint8_t session, uint8_t packet_num) {
+    if (f.count && f.session != session) commandFilterReset(f);
+    f.session = session;
+    f.recent[f.pos] = packet_num;
+    f.pos = (f.pos + 1) % RECENT_COMMANDS;
+    if (f.count < RECENT_COMMANDS) f.count++;
+}
+
+// true — повтор; новая команда запоминается
+inline bool commandFilterSeen(CommandFilter &f, uint8_t session, uint8_t packet_num) {
+    if (f.count && f.session == session) {
+        for (uint8_t i = 0; i < f.count; i++) {
+            if (f.recent[i] == packet_num) return true;
+        }
+    }
+    commandFilterRemember(f, session, packet_num);
+    return false;
+}
+
+// ════════════════════════════════════════════════════════════
+// РАЗБОР КОМАНД (КС)
+// ════════════════════════════════════════════════════════════
+// Поля положения, ШИМ, лазера и скрипта — команда меняет состояние КС
+inline bool commandHasActions(const NRF_BS2CS &p) {
+    return p.fields.pos_x != 0xFF || p.fields.pos_y != 0xFF ||
+           p.fields.pwm_x != 0xFFFF || p.fields.pwm_y != 0xFFFF ||
+           p.fields.pwr_laser != 0xFF || p.fields.script != 0xFF;
+}
+
+#define STEP_MS_MIN               50      // нижняя граница периода шага
+#define TELEMETRY_MS_DEFAULT      3000
+#define STEP_MS_DEFAULT           300
+
+// Конфигурация КС, сохраняемая в EEPROM (Storage.cpp)
+struct CubeSatConfig {
+    uint16_t telemetryMs;     // период телеметрии, 0 — только по событиям
+    uint16_t stepMs;          // период шага сканирования
+    uint16_t servoXMinUs;     // калибровка: ШИМ при -40° и +40°
+    uint16_t servoXMaxUs;
+    uint16_t servoYMinUs;
+    uint16_t servoYMaxUs;
+};
+
+inline bool servoRangeValid(uint16_t minUs, uint16_t maxUs) {
+    return minUs >= 500 && maxUs <= 2500 && minUs < maxUs;
+}
+
+inline bool configValid(const CubeSatConfig &c) {
+    return c.stepMs >= STEP_MS_MIN &&
+           servoRangeValid(c.servoXMinUs, c.servoXMaxUs) &&
+           servoRangeValid(c.servoYMinUs, c.servoYMaxUs);
+}
+
+// Поля конфигурации команды; false — калибровка вне допустимых границ
+inline bool configApplyCommand(CubeSatConfig &c, const NRF_BS2CS &p, const CubeSatConfig &defaults) {
+    if (p.fields.time_telem != 0xFF) c.telemetryMs = p.fields.time_telem * 100;
+    if (p.fields.time_step != 0xFF) {
+        c.stepMs = p.fields.time_step * 10;
+        if (c.stepMs < STEP_MS_MIN) c.stepMs = STEP_MS_MIN;
+    }
+
+    switch (p.fields.cfg_key) {
+        case CFG_SERVO_X:
+        case CFG_SERVO_Y:
+            if (!servoRangeValid(p.fields.cfg_value, p.fields.cfg_value2)) return false;
+            if (p.fields.cfg_key == CFG_SERVO_X) {
+                c.servoXMinUs = p.fields.cfg_value;
+                c.servoXMaxUs = p.fields.cfg_value2;
+            } else {
+                c.servoYMinUs = p.fields.cfg_value;
+                c.servoYMaxUs = p.fields.cfg_value2;
+            }
+            break;
+        case CFG_DEFAULTS:
+            c = defaults;
+            break;
+    }
+    return true;
+}
+
+#endif
@@ -2,12 +2,17 @@
 #include <Arduino.h>
 #include "Data_Structures.h"
 #include "Actuators.h"
+#include "Detector.h"
 #include "StateMachine.h"
 
 
 StateManager stateManager;
+AcqSearch acqSearch;
 bool autoScanEnabled = false;
 
+static uint32_t acqStartTime = 0;
+static uint16_t acqDwell = 0;
+
 void stateMachineSetup() {
     stateManager.currentState = STATE_IDLE;
     stateManager.nextState = STATE_IDLE;
@@ -17,11 +22,18 @@ void stateMachineSetup() {
     stateManager.moveComplete = true;
     stateManager.lastStepTime = millis();
     stateManager.stepInterval = 300;
+    stateManager.acqLockTime = 0;
+    acqSearch.errorTenths = 0xFF;
     
     Serial.println(F("[StateMachine] Initialized ✓"));
 }
 
 void updateStateMachine() {
+    if (stateManager.currentState == STATE_ACQUIRE) {
+        updateAcquisition();
+        return;
+    }
+    
     if (!autoScanEnabled) return;
     
     uint32_t currentTime = millis();
@@ -39,6 +51,13 @@ void setSystemState(SystemState newState) {
     Serial.print(F(" → "));
     Serial.println(newState);
     
+    // Захват действителен только в режиме ACQUIRE — телеметрия
+    // не должна сообщать его после выхода
+    if (stateManager.currentState == STATE_ACQUIRE) {
+        stateManager.acqLockTime = 0;
+        acqSearch.errorTenths = 0xFF;
+    }
+    
     stateManager.currentState = newState;
     stateManager.currentStep = 0;
     stateManager.moveComplete = false;
@@ -91,6 +110,80 @@ void setSystemState(SystemState newState) {
             autoScanEnabled = false;
             Serial.println(F("  → MANUAL"));
             break;
+            
+        case STATE_ACQUIRE:
+            autoScanEnabled = false;
+            setServo(true);
+            acqStart(acqSearch);
+            acqStartTime = millis();
+            acqDwell = acqDwellMs(currentAngleX, currentAngleY, acqSearch.pointX, acqSearch.pointY);
+            stateManager.acqLockTime = 0;
+            stateManager.targetAngleX = acqSearch.pointX;
+            stateManager.targetAngleY = acqSearch.pointY;
+            updatePositionXY(acqSearch.pointX, acqSearch.pointY);
+            Serial.println(F("  → ACQUIRE (coarse grid → spiral → hold)"));
+            break;
+    }
+}
+
+// ══════════════════════════════════════════════════════════════
+// ЗАХВАТ ЦЕЛИ ПО ФОТОПРИЁМНИКУ
+// ══════════════════════════════════════════════════════════════
+void updateAcquisition() {
+    uint32_t currentTime = millis();
+    if (currentTime - stateManager.lastStepTime < acqDwell) return;
+    stateManager.lastStepTime = currentTime;
+    
+    AcqPhase before = acqSearch.phase;
+    int8_t fromX = acqSearch.pointX;
+    int8_t fromY = acqSearch.pointY;
+    
+    acqFeed(acqSearch, readDetector());
+    stateManager.currentStep = acqSearch.phase;
+    
+    if (acqSearch.phase == ACQ_FAILED) {
+        Serial.print(F("[Acquire] Target not found ("));
+        Serial.print(acqSearch.points);
+        Serial.println(F(" points)"));
+        setLaser(false);
+        setSystemState(STATE_IDLE);
+        return;
+    }
+    
+    // Срыв удержания: время захвата считается от начала повторного поиска
+    if (before == ACQ_HOLD && acqSearch.phase != ACQ_HOLD) {
+        acqStartTime = currentTime;
+        stateManager.acqLockTime = 0;
+        Serial.println(F("[Acquire] Target lost, re-acquiring"));
+    }
+    
+    if (acqSearch.phase == ACQ_HOLD && before != ACQ_HOLD) {
+        stateManager.acqLockTime = currentTime - acqStartTime;
+        Serial.print(F("[Acquire] ★ LOCK X="));
+        Serial.print(acqSearch.bestX);
+        Serial.print(F(" Y="));
+        Serial.print(acqSearch.bestY);
+        Serial.print(F(" | level "));
+        Serial.print(acqSearch.bestLevel);
+        Serial.print(F(" | "));
+        Serial.print(stateManager.acqLockTime);
+        Serial.print(F(" ms, "));
+        Serial.print(acqSearch.points);
+        Serial.print(F(" points | error ~"));
+        Serial.print(acqSearch.errorTenths / 10.0, 1);
+        Serial.println(F("°"));
+    }
+    
+    if (acqSearch.phase == ACQ_HOLD) {
+        acqDwell = ACQ_HOLD_PERIOD_MS;
+    } else {
+        acqDwell = acqDwellMs(fromX, fromY, acqSearch.pointX, acqSearch.pointY);
+    }
+    
+    if (acqSearch.pointX != fromX || acqSearch.pointY != fromY) {
+        stateManager.targetAngleX = acqSearch.pointX;
+        stateManager.targetAngleY = acqSearch.pointY;
+        updatePositionXY(acqSearch.pointX, acqSearch.pointY);
     }
 }
 
@@ -172,6 +265,7 @@ void processScriptCommand(uint8_t script) {
         case 4: setSystemState(STATE_SCAN_VERTICAL); setLaser(true); break;
         case 5: setSystemState(STATE_SCAN_DIAGONAL_1); setLaser(true); break;
         case 6: setSystemState(STATE_SCAN_DIAGONAL_2); setLaser(true); break;
+        case 7: setSystemState(STATE_ACQUIRE); setLaser(true); break;
         default: break;
     }
 }
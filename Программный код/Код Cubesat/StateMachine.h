@@ -3,6 +3,7 @@
 #define STATE_MACHINE_H
 
 #include <stdint.h>
+#include "Acquisition.h"
 
 // ══════════════════════════════════════════════════════════════
 // РЕЖИМЫ СИСТЕМЫ
@@ -13,7 +14,8 @@ enum SystemState {
     STATE_SCAN_VERTICAL = 2,
     STATE_SCAN_DIAGONAL_1 = 3,
     STATE_SCAN_DIAGONAL_2 = 4,
-    STATE_MANUAL = 5
+    STATE_MANUAL = 5,
+    STATE_ACQUIRE = 6
 };
 
 // ══════════════════════════════════════════════════════════════
@@ -28,9 +30,11 @@ struct StateManager {
     bool moveComplete;
     uint32_t lastStepTime;
     uint32_t stepInterval;
+    uint32_t acqLockTime;     // время захвата цели, мс (0 — нет захвата)
 };
 
 extern StateManager stateManager;
+extern AcqSearch acqSearch;
 
 // ══════════════════════════════════════════════════════════════
 // ФУНКЦИИ
@@ -39,6 +43,7 @@ void stateMachineSetup();
 void updateStateMachine();
 void setSystemState(SystemState newState);
 void executeScanStep();
+void updateAcquisition();
 void stopAllActions();
 void processScriptCommand(uint8_t script);
 
@@ -0,0 +1,166 @@
+// Storage.cpp
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "Data_Structures.h"
+#include "Actuators.h"
+#include "StateMachine.h"
+#include "Storage.h"
+#include "StorageRing.h"
+
+
+// ══════════════════════════════════════════════════════════════
+// ГЛОБАЛЬНЫЕ ПЕРЕМЕННЫЕ
+// ══════════════════════════════════════════════════════════════
+CubeSatConfig config;
+CubeSatSnapshot savedState;           // последнее записанное состояние
+
+static StorageRing configRing = {STORAGE_CONFIG_BASE, STORAGE_CONFIG_SLOTS, sizeof(CubeSatConfig), STORAGE_CONFIG_ID, 0, 0, false};
+static StorageRing stateRing = {STORAGE_CONFIG_BASE + STORAGE_RING_BYTES(STORAGE_CONFIG_SLOTS, sizeof(CubeSatConfig)),
+                                STORAGE_STATE_SLOTS, sizeof(CubeSatSnapshot), STORAGE_STATE_ID, 0, 0, false};
+
+static_assert(STORAGE_CONFIG_BASE + STORAGE_RING_BYTES(STORAGE_CONFIG_SLOTS, sizeof(CubeSatConfig)) +
+              STORAGE_RING_BYTES(STORAGE_STATE_SLOTS, sizeof(CubeSatSnapshot)) <= E2END + 1,
+              "EEPROM layout does not fit");
+static_assert(_BV(PORF) == RESET_PORF && _BV(BORF) == RESET_BORF, "MCUSR reset flags");
+
+static uint32_t lastStateSaveMs = 0;
+
+// ══════════════════════════════════════════════════════════════
+// ДОСТУП К EEPROM
+// ══════════════════════════════════════════════════════════════
+static uint8_t eepromRead(uint16_t addr) {
+    return EEPROM.read(addr);
+}
+
+static void eepromUpdate(uint16_t addr, uint8_t value) {
+    EEPROM.update(addr, value);
+}
+
+static const StorageMemory eeprom = {eepromRead, eepromUpdate};
+
+// ══════════════════════════════════════════════════════════════
+// КОНФИГУРАЦИЯ
+// ══════════════════════════════════════════════════════════════
+static void configDefaults(CubeSatConfig &c) {
+    c.telemetryMs = TELEMETRY_MS_DEFAULT;
+    c.stepMs = STEP_MS_DEFAULT;
+    c.servoXMinUs = SERVO_X_MIN_US;
+    c.servoXMaxUs = SERVO_X_MAX_US;
+    c.servoYMinUs = SERVO_Y_MIN_US;
+    c.servoYMaxUs = SERVO_Y_MAX_US;
+}
+
+// Поля конфигурации в команде; true — конфигурация изменена и записана
+bool storageApplyCommand(const NRF_BS2CS &packet) {
+    CubeSatConfig c = config;
+    CubeSatConfig defaults;
+    configDefaults(defaults);
+
+    if (!configApplyCommand(c, packet, defaults)) {
+        Serial.println(F("[Storage] ERROR: Servo range rejected"));
+    }
+
+    if (memcmp(&c, &config, sizeof(c)) == 0) return false;
+
+    config = c;
+    storageRingSave(eeprom, configRing, &config);
+    Serial.print(F("[Storage] Config saved #"));
+    Serial.println(configRing.seq);
+    return true;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ИНИЦИАЛИЗАЦИЯ
+// ══════════════════════════════════════════════════════════════
+uint8_t storageSetup(uint8_t resetFlags) {
+    if (!storageRingLoad(eeprom, configRing, &config) || !configValid(config)) {
+        configDefaults(config);
+        Serial.println(F("[Storage] No config — firmware defaults"));
+    }
+
+    if (!storageRingLoad(eeprom, stateRing, &savedState)) {
+        memset(&savedState, 0, sizeof(savedState));
+        savedState.mode = STATE_IDLE;
+        Serial.println(F("[Storage] No saved state"));
+        return STORAGE_FRESH;
+    }
+
+    uint8_t restore = storageRestoreMode(savedState, resetFlags);
+
+    if (storageBrownOut(resetFlags)) {
+        storageRingSave(eeprom, stateRing, &savedState);
+
+        if (savedState.brownouts >= STORAGE_BROWNOUT_LIMIT) {
+            Serial.println(F("[Storage] WARNING: Repeated brown-outs, staying IDLE"));
+        }
+    }
+    lastStateSaveMs = millis();
+
+    return restore;
+}
+
+// ══════════════════════════════════════════════════════════════
+// СОХРАНЕНИЕ СОСТОЯНИЯ
+// ══════════════════════════════════════════════════════════════
+void storageUpdate(CubeSatSnapshot state) {
+    uint32_t now = millis();
+    state.brownouts = (now < STORAGE_STABLE_MS) ? savedState.brownouts : 0;
+
+    if (memcmp(&state, &savedState, sizeof(state)) == 0) return;
+
+    // Номер выполненной команды — тоже сразу: после сброса в окне
+    // STORAGE_STATE_PERIOD_MS повтор той же команды выполнился бы снова.
+    // Запись идёт только по новой команде, износ ограничен.
+    bool urgent = state.mode != savedState.mode || state.laser != savedState.laser ||
+                  state.lastCmdNum != savedState.lastCmdNum || state.lastCmdSession != savedState.lastCmdSession;
+    if (!urgent && now - lastStateSaveMs < STORAGE_STATE_PERIOD_MS) return;
+
+    storageRingSave(eeprom, stateRing, &state);
+    savedState = state;
+    lastStateSaveMs = now;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ДИАГНОСТИКА
+// ══════════════════════════════════════════════════════════════
+void printStorageStatus() {
+    Serial.println(F("\n[Storage]"));
+    Serial.print(F("  Config: "));
+    if (configRing.valid) {
+        Serial.print(F("#"));
+        Serial.print(configRing.seq);
+        Serial.print(F(" slot "));
+        Serial.println(configRing.slot);
+    } else {
+        Serial.println(F("defaults"));
+    }
+    Serial.print(F("  Telemetry: "));
+    Serial.print(config.telemetryMs);
+    Serial.print(F(" ms | Step: "));
+    Serial.print(config.stepMs);
+    Serial.println(F(" ms"));
+    Serial.print(F("  Servo X: "));
+    Serial.print(config.servoXMinUs);
+    Serial.print(F("-"));
+    Serial.print(config.servoXMaxUs);
+    Serial.print(F(" µs | Y: "));
+    Serial.print(config.servoYMinUs);
+    Serial.print(F("-"));
+    Serial.print(config.servoYMaxUs);
+    Serial.println(F(" µs"));
+    Serial.print(F("  State: "));
+    if (stateRing.valid) {
+        Serial.print(F("#"));
+        Serial.print(stateRing.seq);
+        Serial.print(F(" slot "));
+        Serial.print(stateRing.slot);
+        Serial.print(F(" | mode "));
+        Serial.print(savedState.mode);
+        Serial.print(F(" step "));
+        Serial.print(savedState.step);
+        Serial.print(F(" | brown-outs "));
+        Serial.println(savedState.brownouts);
+    } else {
+        Serial.println(F("none"));
+    }
+}
@@ -0,0 +1,69 @@
+// Storage.h
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <stdint.h>
+#include "Protocol.h"
+
+// ══════════════════════════════════════════════════════════════
+// РАЗМЕТКА EEPROM
+// ══════════════════════════════════════════════════════════════
+// Каждый блок — кольцо записей [id][seq][данные][crc]. Новая запись
+// ложится в следующую ячейку кольца с seq + 1, так износ делится на
+// все ячейки; запись, прерванная сбросом, не проходит CRC, и при
+// загрузке берётся предыдущая. id меняется вместе со структурой блока.
+#define STORAGE_CONFIG_BASE       0
+#define STORAGE_CONFIG_SLOTS      8
+#define STORAGE_CONFIG_ID         0xC1
+#define STORAGE_STATE_SLOTS       59      // 59 × 15 байт после блока конфигурации
+#define STORAGE_STATE_ID          0x52
+
+// Прогресс сканирования пишется не чаще STORAGE_STATE_PERIOD_MS, смена
+// режима, лазера и номера выполненной команды — сразу. 59 ячеек × 100 000
+// циклов — около 135 суток непрерывного сканирования.
+#define STORAGE_STATE_PERIOD_MS   2000
+
+// Сброс по провалу питания (BORF) возобновляет прерванный режим. Если
+// провалы идут подряд — скорее всего, их вызывают сами приводы: начиная
+// с STORAGE_BROWNOUT_LIMIT-го сброса КС остаётся в IDLE. Счётчик обнуляется
+// после STORAGE_STABLE_MS работы без сброса.
+#define STORAGE_BROWNOUT_LIMIT    3
+#define STORAGE_STABLE_MS         10000
+
+// Что восстановлено при старте
+#define STORAGE_FRESH             0       // записей нет — значения прошивки
+#define STORAGE_POSITION          1       // положение и номер последней команды
+#define STORAGE_RESUME            2       // плюс прерванный режим
+
+// ══════════════════════════════════════════════════════════════
+// БЛОКИ
+// ══════════════════════════════════════════════════════════════
+// Блок конфигурации — CubeSatConfig из Protocol.h
+struct CubeSatSnapshot {
+    uint8_t mode;             // SystemState
+    uint8_t step;
+    int8_t targetX;
+    int8_t targetY;
+    int8_t angleX;
+    int8_t angleY;
+    uint8_t laser;
+    uint8_t lastCmdNum;       // последняя выполненная команда — для фильтра повторов
+    uint8_t lastCmdSession;   // и сеанс БС, выдавший её
+    uint8_t brownouts;        // сбросов по питанию подряд
+};
+
+// ══════════════════════════════════════════════════════════════
+// ЭКСТЕРНЫЕ ГЛОБАЛЬНЫЕ ПЕРЕМЕННЫЕ
+// ══════════════════════════════════════════════════════════════
+extern CubeSatConfig config;
+extern CubeSatSnapshot savedState;
+
+// ══════════════════════════════════════════════════════════════
+// ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+uint8_t storageSetup(uint8_t resetFlags);
+bool storageApplyCommand(const NRF_BS2CS &packet);
+void storageUpdate(CubeSatSnapshot state);
+void printStorageStatus();
+
+#endif
@@ -0,0 +1,92 @@
+// StorageRing.cpp
+#include <stdint.h>
+#include <string.h>
+#include "Data_Structures.h"
+#include "StateMachine.h"
+#include "StorageRing.h"
+
+
+// ══════════════════════════════════════════════════════════════
+// ЗАПИСИ
+// ══════════════════════════════════════════════════════════════
+static uint16_t slotAddress(const StorageRing &ring, uint8_t slot) {
+    return ring.base + slot * (ring.size + STORAGE_RECORD_OVERHEAD);
+}
+
+// Запись действительна, если совпали id и CRC
+static bool readRecord(const StorageMemory &mem, const StorageRing &ring, uint8_t slot, uint16_t &seq) {
+    uint16_t addr = slotAddress(ring, slot);
+    if (mem.read(addr) != ring.id) return false;
+
+    uint16_t crc = 0;
+    for (uint8_t i = 0; i < ring.size + 3; i++) {
+        crc = crc16_ccitt_update(crc, mem.read(addr + i));
+    }
+    uint16_t stored = mem.read(addr + ring.size + 3) | (mem.read(addr + ring.size + 4) << 8);
+    if (crc != stored) return false;
+
+    seq = mem.read(addr + 1) | (mem.read(addr + 2) << 8);
+    return true;
+}
+
+// Самая новая действительная запись; seq сравнивается с учётом переполнения
+bool storageRingLoad(const StorageMemory &mem, StorageRing &ring, void *data) {
+    uint16_t seq;
+
+    ring.valid = false;
+    for (uint8_t slot = 0; slot < ring.slots; slot++) {
+        if (!readRecord(mem, ring, slot, seq)) continue;
+        if (ring.valid && (int16_t)(seq - ring.seq) <= 0) continue;
+        ring.valid = true;
+        ring.slot = slot;
+        ring.seq = seq;
+    }
+    if (!ring.valid) return false;
+
+    uint16_t addr = slotAddress(ring, ring.slot) + 3;
+    uint8_t *bytes = (uint8_t *)data;
+    for (uint8_t i = 0; i < ring.size; i++) bytes[i] = mem.read(addr + i);
+    return true;
+}
+
+// update() пропускает неизменные байты: 3,3 мс уходят только на
+// изменившиеся. Старая запись не затирается, пока новая не записана целиком.
+void storageRingSave(const StorageMemory &mem, StorageRing &ring, const void *data) {
+    uint8_t slot = ring.valid ? (ring.slot + 1) % ring.slots : 0;
+    uint16_t seq = ring.seq + 1;
+    uint16_t addr = slotAddress(ring, slot);
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint8_t header[3] = {ring.id, (uint8_t)(seq & 0xFF), (uint8_t)(seq >> 8)};
+    uint16_t crc = 0;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        mem.update(addr++, header[i]);
+        crc = crc16_ccitt_update(crc, header[i]);
+    }
+    for (uint8_t i = 0; i < ring.size; i++) {
+        mem.update(addr++, bytes[i]);
+        crc = crc16_ccitt_update(crc, bytes[i]);
+    }
+    mem.update(addr++, crc & 0xFF);
+    mem.update(addr, crc >> 8);
+
+    ring.slot = slot;
+    ring.seq = seq;
+    ring.valid = true;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ВОССТАНОВЛЕНИЕ ПОСЛЕ СБРОСА
+// ══════════════════════════════════════════════════════════════
+// При включении питания BORF тоже может быть выставлен — это не провал
+bool storageBrownOut(uint8_t resetFlags) {
+    return (resetFlags & RESET_BORF) && !(resetFlags & RESET_PORF);
+}
+
+uint8_t storageRestoreMode(CubeSatSnapshot &state, uint8_t resetFlags) {
+    if (!storageBrownOut(resetFlags)) return STORAGE_POSITION;
+
+    if (state.brownouts < 0xFF) state.brownouts++;
+    if (state.mode != STATE_IDLE && state.brownouts < STORAGE_BROWNOUT_LIMIT) return STORAGE_RESUME;
+    return STORAGE_POSITION;
+}
@@ -0,0 +1,48 @@
+// StorageRing.h
+#ifndef STORAGE_RING_H
+#define STORAGE_RING_H
+
+#include <stdint.h>
+#include "Storage.h"
+
+// ══════════════════════════════════════════════════════════════
+// КОЛЬЦО ЗАПИСЕЙ EEPROM
+// ══════════════════════════════════════════════════════════════
+// Логика не зависит от Arduino: память доступна через StorageMemory,
+// тот же код проверяет «Код ПК/storage_test.cpp».
+struct StorageMemory {
+    uint8_t (*read)(uint16_t addr);
+    void (*update)(uint16_t addr, uint8_t value);   // как EEPROM.update()
+};
+
+struct StorageRing {
+    uint16_t base;
+    uint8_t slots;
+    uint8_t size;                     // байт данных в записи
+    uint8_t id;
+    uint8_t slot;                     // ячейка последней записи
+    uint16_t seq;
+    bool valid;                       // в кольце есть действующая запись
+};
+
+// id + seq + данные + crc
+#define STORAGE_RECORD_OVERHEAD   5
+#define STORAGE_RING_BYTES(slots, size)  ((slots) * ((size) + STORAGE_RECORD_OVERHEAD))
+
+// Флаги сброса MCUSR (ATmega328P)
+#define RESET_PORF                0x01
+#define RESET_BORF                0x04
+
+// ══════════════════════════════════════════════════════════════
+// ФУНКЦИИ
+// ══════════════════════════════════════════════════════════════
+bool storageRingLoad(const StorageMemory &mem, StorageRing &ring, void *data);
+void storageRingSave(const StorageMemory &mem, StorageRing &ring, const void *data);
+
+// Сброс по провалу питания: BORF без PORF
+bool storageBrownOut(uint8_t resetFlags);
+// Что восстанавливать из записанного состояния; при провале питания
+// увеличивает счётчик brownouts (его нужно записать)
+uint8_t storageRestoreMode(CubeSatSnapshot &state, uint8_t resetFlags);
+
+#endif
@@ -5,8 +5,13 @@
 #include <Servo.h>
 
 #include "Data_Structures.h"
+#include "Protocol.h"
 #include "Actuators.h"
+#include "Detector.h"
 #include "StateMachine.h"
+#include "Power.h"
+#include "Storage.h"
+#include "Boot.h"
 
 // ══════════════════════════════════════════════════════════════
 // КОНФИГУРАЦИЯ NRF24
@@ -29,6 +34,10 @@ uint32_t packetsReceived = 0;
 uint32_t telemetrySent = 0;
 uint8_t telemetryCounter = 0;
 uint8_t lastPacketNumber = 0;
+uint8_t lastChangeCommand = 0;        // последняя команда, изменившая состояние
+uint8_t lastChangeSession = 0;        // и сеанс БС, выдавший её
+
+CommandFilter recentCommands;        // повторы потоковой передачи БС
 uint32_t lastTelemetryTime = 0;
 
 bool newPacketAvailable = false;
@@ -39,16 +48,21 @@ bool autoTelemetryEnabled = true;
 // SETUP
 // ══════════════════════════════════════════════════════════════
 void setup() {
-    Serial.begin(115200);
-    while (!Serial) {}
+    // Лазер выключается раньше всего остального
+    pinMode(LASER_PIN, OUTPUT);
+    digitalWrite(LASER_PIN, LOW);
+    uint8_t resetFlags = bootResetFlags();
     
-    Serial.println(F("\n════════════════════════════════════════"));
-    Serial.println(F("  CUBESAT - LASER POINTING v3.0"));
-    Serial.println(F("  Status Mask + CRC Implementation"));
-    Serial.println(F("════════════════════════════════════════\n"));
+    // Монитор порта не ждём: без USB-хоста КС стартует так же
+    Serial.begin(115200);
+    bootMark(F("serial"));
     
-    actuatorsSetup();
-    stateMachineSetup();
+    uint8_t restore = storageSetup(resetFlags);
+    if (restore != STORAGE_FRESH) {
+        currentAngleX = savedState.angleX;
+        currentAngleY = savedState.angleY;
+    }
+    bootMark(F("storage"));
     
     Serial.println(F("[Radio] Initializing NRF24L01+..."));
     if (!radio.begin()) {
@@ -66,9 +80,88 @@ void setup() {
     radio.startListening();
     
     Serial.println(F("[Radio] Ready ✓\n"));
+    bootMark(F("radio"));
     
-    lastTelemetryTime = millis();
+    actuatorsSetup();
+    stateMachineSetup();
+    applyConfig();
+    restoreState(restore);
+    bootMark(F("actuators + state"));
+    
+    // Первая телеметрия — как только известно состояние, остальное
+    // догружается после. STATUS_BOOT держится до первой доставленной
+    // телеметрии: БС видит перезапуск, даже если этот кадр потерян, а
+    // метка времени считается от старта скетча (без загрузчика)
+    statusMask |= STATUS_BOOT;
     sendTelemetryFlag = true;
+    sendTelemetry();
+    lastTelemetryTime = millis();
+    bootMark(F("first telemetry"));
+    
+    detectorSetup();
+    powerSetup(radio, RF24_CE_PIN);
+    bootMark(F("detector + power"));
+    
+    // Баннер и отчёты — в конце: на 115200 вывод блокирует ~1 мс на 11 байт
+    Serial.println(F("\n════════════════════════════════════════"));
+    Serial.println(F("  CUBESAT - LASER POINTING v3.0"));
+    Serial.println(F("  Status Mask + CRC Implementation"));
+    Serial.println(F("════════════════════════════════════════"));
+    printBootReport();
+    printStorageStatus();
+    Serial.println();
+}
+
+// ══════════════════════════════════════════════════════════════
+// КОНФИГУРАЦИЯ И ВОССТАНОВЛЕНИЕ СОСТОЯНИЯ
+// ══════════════════════════════════════════════════════════════
+void applyConfig() {
+    stateManager.stepInterval = config.stepMs;
+    autoTelemetryEnabled = config.telemetryMs != 0;
+}
+
+void restoreState(uint8_t restore) {
+    if (restore == STORAGE_FRESH) return;
+    
+    // Повтор команды, выполненной до сброса, не выполняется второй раз;
+    // команды перезапущенной БС идут с другим сеансом и очищают фильтр
+    lastPacketNumber = savedState.lastCmdNum;
+    lastChangeCommand = savedState.lastCmdNum;
+    lastChangeSession = savedState.lastCmdSession;
+    commandFilterRemember(recentCommands, savedState.lastCmdSession, savedState.lastCmdNum);
+    
+    if (restore != STORAGE_RESUME) return;
+    
+    SystemState mode = (SystemState)savedState.mode;
+    setSystemState(mode);
+    
+    // Сканирование продолжается с прерванного шага, захват цели — заново
+    if (mode != STATE_ACQUIRE) {
+        stateManager.currentStep = savedState.step;
+        stateManager.targetAngleX = savedState.targetX;
+        stateManager.targetAngleY = savedState.targetY;
+        updatePositionXY(savedState.targetX, savedState.targetY);
+    }
+    setLaser(savedState.laser);
+    
+    Serial.print(F("[Storage] Resumed mode "));
+    Serial.print(mode);
+    Serial.print(F(" at step "));
+    Serial.println(stateManager.currentStep);
+}
+
+void saveState() {
+    CubeSatSnapshot state;
+    state.mode = stateManager.currentState;
+    state.step = stateManager.currentStep;
+    state.targetX = stateManager.targetAngleX;
+    state.targetY = stateManager.targetAngleY;
+    state.angleX = currentAngleX;
+    state.angleY = currentAngleY;
+    state.laser = laserState ? 1 : 0;
+    state.lastCmdNum = lastChangeCommand;
+    state.lastCmdSession = lastChangeSession;
+    storageUpdate(state);
 }
 
 // ══════════════════════════════════════════════════════════════
@@ -93,29 +186,29 @@ void processPacket() {
     if (!newPacketAvailable) return;
     newPacketAvailable = false;
     
-    if (rxPacket.fields.header != 0x37) {
+    uint8_t check = checkCommandPacket(rxPacket);
+    
+    if (check == PACKET_BAD_HEADER) {
         Serial.println(F("[Packet] ERROR: Invalid header!"));
         statusMask &= ~STATUS_CRC_OK;
         return;
     }
     
-    if (rxPacket.fields.sat_id != 0x25) {
+    if (check == PACKET_BAD_SAT_ID) {
         Serial.println(F("[Packet] WARNING: Not for this satellite"));
         statusMask &= ~STATUS_CRC_OK;
         return;
     }
     
     // ПРОВЕРКА CRC
-    uint16_t received_crc = rxPacket.fields.crc;
-    rxPacket.fields.crc = 0;
-    uint16_t calculated_crc = calculateCRC16(rxPacket.raw, sizeof(rxPacket.raw));
-    rxPacket.fields.crc = received_crc;
-    
-    if (calculated_crc != received_crc) {
+    if (check == PACKET_BAD_CRC) {
         Serial.print(F("[Packet] CRC ERROR! Got 0x"));
-        Serial.print(received_crc, HEX);
+        Serial.print(rxPacket.fields.crc, HEX);
         Serial.print(F(", expected 0x"));
-        Serial.println(calculated_crc, HEX);
+        Serial.println(packetCRC16(rxPacket.raw), HEX);
+        if (packetLegacyCRC(rxPacket.raw)) {
+            Serial.println(F("[Packet] BS runs the old firmware — reflash both stations"));
+        }
         statusMask &= ~STATUS_CRC_OK;
         return;
     }
@@ -123,48 +216,62 @@ void processPacket() {
     statusMask |= STATUS_CRC_OK;
     statusMask |= STATUS_PACKET_LEN_OK;
     
-    bool changesMade = false;
+    // ──── ПОВТОР КОМАНДЫ ────
+    if (commandFilterSeen(recentCommands, rxPacket.fields.session, rxPacket.fields.packet_num)) {
+        Serial.print(F("[Packet] Duplicate #"));
+        Serial.print(rxPacket.fields.packet_num);
+        Serial.println(F(" ignored"));
+        return;
+    }
+    
+    powerCommandReceived();
+    
+    bool changesMade = commandHasActions(rxPacket);
     
     // ──── ПОЗИЦИЯ ────
     if (rxPacket.fields.pos_x != 0xFF) {
         int8_t angle_x = nrfToAngle(rxPacket.fields.pos_x);
         updatePositionX(angle_x);
-        changesMade = true;
     }
     
     if (rxPacket.fields.pos_y != 0xFF) {
         int8_t angle_y = nrfToAngle(rxPacket.fields.pos_y);
         updatePositionY(angle_y);
-        changesMade = true;
     }
     
     // ──── ШИМ (приоритет выше) ────
     if (rxPacket.fields.pwm_x != 0xFFFF) {
         updatePWM_X(rxPacket.fields.pwm_x);
-        changesMade = true;
     }
     
     if (rxPacket.fields.pwm_y != 0xFFFF) {
         updatePWM_Y(rxPacket.fields.pwm_y);
-        changesMade = true;
     }
     
     // ──── ЛАЗЕР ────
     if (rxPacket.fields.pwr_laser != 0xFF) {
         setLaser(rxPacket.fields.pwr_laser == 1);
-        changesMade = true;
     }
     
     // ──── СКРИПТ ────
     if (rxPacket.fields.script != 0xFF) {
         processScriptCommand(rxPacket.fields.script);
+    }
+    
+    // ──── КОНФИГУРАЦИЯ (сохраняется в EEPROM) ────
+    if (storageApplyCommand(rxPacket)) {
+        applyConfig();
+        if (servoState) updatePositionXY(currentAngleX, currentAngleY);
         changesMade = true;
     }
     
     lastPacketNumber = rxPacket.fields.packet_num;
     
     if (changesMade) {
+        lastChangeCommand = rxPacket.fields.packet_num;
+        lastChangeSession = rxPacket.fields.session;
         sendTelemetryFlag = true;
+        powerActivity();
         Serial.println(F("[Packet] Processed ✓"));
     }
 }
@@ -173,28 +280,27 @@ void processPacket() {
 // ОТПРАВКА ТЕЛЕМЕТРИИ (с CRC)
 // ══════════════════════════════════════════════════════════════
 void sendTelemetry() {
-    if (!sendTelemetryFlag && !autoTelemetryEnabled) return;
+    // Период задаёт periodicTelemetry(); без флага кадр не отправляется
+    if (!sendTelemetryFlag) return;
     sendTelemetryFlag = false;
     telemetryCounter++;
     
-    txPacket.fields.header = 0x38;
-    txPacket.fields.sat_id = 0x25;
-    txPacket.fields.packet_num = telemetryCounter;
     txPacket.fields.last_cmd_num = lastPacketNumber;
     txPacket.fields.timestamp = millis();
     txPacket.fields.status = statusMask;
     txPacket.fields.mode = stateManager.currentState;
     txPacket.fields.script_step = stateManager.currentStep;
-    txPacket.fields.pwm_x = angleToPWM(currentAngleX, SERVO_X_MIN_US, SERVO_X_MAX_US);
-    txPacket.fields.pwm_y = angleToPWM(currentAngleY, SERVO_Y_MIN_US, SERVO_Y_MAX_US);
+    txPacket.fields.pwm_x = angleToPWM(currentAngleX, config.servoXMinUs, config.servoXMaxUs);
+    txPacket.fields.pwm_y = angleToPWM(currentAngleY, config.servoYMinUs, config.servoYMaxUs);
     txPacket.fields.pos_x = currentAngleX;
     txPacket.fields.pos_y = currentAngleY;
     txPacket.fields.pwr_laser = laserState ? 1 : 0;
-    txPacket.fields.pwr_servo = (stateManager.currentState != STATE_IDLE) ? 1 : 0;
+    txPacket.fields.pwr_servo = servoState ? 1 : 0;
+    txPacket.fields.acq_time = (stateManager.acqLockTime / 10 > 0xFFFF) ? 0xFFFF : stateManager.acqLockTime / 10;
+    txPacket.fields.acq_error = acqSearch.errorTenths;
     
-    // ВЫЧИСЛЯЕМ CRC
-    txPacket.fields.crc = 0;
-    txPacket.fields.crc = calculateCRC16(txPacket.raw, sizeof(txPacket.raw));
+    // ЗАГОЛОВОК И CRC
+    sealTelemetryPacket(txPacket, telemetryCounter);
     
     // ОТПРАВЛЯЕМ
     radio.stopListening();
@@ -203,6 +309,7 @@ void sendTelemetry() {
     
     if (success) {
         telemetrySent++;
+        statusMask &= ~STATUS_BOOT;
         Serial.print(F("[Telemetry] #"));
         Serial.print(telemetryCounter);
         Serial.print(F(" → Status: 0x"));
@@ -219,7 +326,7 @@ void sendTelemetry() {
 // ══════════════════════════════════════════════════════════════
 void periodicTelemetry() {
     uint32_t currentTime = millis();
-    if (autoTelemetryEnabled && (currentTime - lastTelemetryTime >= 3000)) {
+    if (autoTelemetryEnabled && (currentTime - lastTelemetryTime >= config.telemetryMs)) {
         sendTelemetryFlag = true;
         lastTelemetryTime = currentTime;
     }
@@ -230,11 +337,36 @@ void periodicTelemetry() {
 // ══════════════════════════════════════════════════════════════
 void loop() {
     checkEmergencyStop();
-    receivePackets();
-    processPacket();
+    
+    // БС передаёт очередь команд подряд — RX FIFO (3 кадра) разбирается целиком
+    bool commandsArriving = false;
+    for (uint8_t i = 0; i < 3 && radio.available(); i++) {
+        receivePackets();
+        processPacket();
+        commandsArriving = true;
+    }
+    
     updateStateMachine();
     sendTelemetry();
     periodicTelemetry();
+    saveState();
+    
+    // ──── СОН ПО РАСПИСАНИЮ ────
+    // БС узнаёт о переходе по STATUS_SLEEP и повторяет кадры дольше
+    // цикла приёма; после пробуждения телеметрия снимает флаг
+    bool busy = stateManager.currentState != STATE_IDLE || laserState || radio.available();
+    if (powerIdleExpired(busy)) {
+        statusMask |= STATUS_SLEEP;
+        sendTelemetryFlag = true;
+        sendTelemetry();
+        powerSleep();
+        statusMask &= ~STATUS_SLEEP;
+        sendTelemetryFlag = true;
+        lastTelemetryTime = millis();
+        return;
+    }
     
-    delay(100);
+    // При захвате цели шаги короче 100 мс — цикл не должен их огрублять;
+    // пока идут команды, короткий цикл не даёт переполниться RX FIFO
+    powerDelay((stateManager.currentState == STATE_ACQUIRE || commandsArriving) ? 10 : 100);
 }
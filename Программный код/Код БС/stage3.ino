@@ -5,6 +5,7 @@
 #include <RF24.h>
 
 #include "Data_Structures.h"
+#include "Protocol.h"
 
 // ══════════════════════════════════════════════════════════════
 // КОНФИГУРАЦИЯ
@@ -21,18 +22,58 @@ const uint8_t RADIO_ADDRESS_TX[6] = "CUBE1";
 #define CMD_VERT_SCAN     4
 #define CMD_DIAG1_SCAN    5
 #define CMD_DIAG2_SCAN    6
+#define CMD_ACQUIRE       7
+#define CMD_CONFIG        8     // конфигурация КС (сохраняется в её EEPROM)
+#define CMD_TXTEST        0     // служебные кадры замера скорости передачи
+
+// ПОТОКОВАЯ ПЕРЕДАЧА (очередь — Protocol.h)
+#define TX_FRAME_TIMEOUT  250   // мс: кадр снимается, если КС не подтвердила его за это время
+
+// СПЯЩАЯ КС: кадр повторяется дольше цикла приёма (с запасом на уход WDT)
+#define TX_WAKE_TIMEOUT   ((SLEEP_LISTEN_PERIOD_MS + SLEEP_LISTEN_WINDOW_MS) * 5 / 4 + TX_FRAME_TIMEOUT)
+#define TELEMETRY_SILENT_PERIODS 3 // без телеметрии дольше стольких периодов — КС молчит
 
 // ══════════════════════════════════════════════════════════════
 // ГЛОБАЛЬНЫЕ ПЕРЕМЕННЫЕ
 // ══════════════════════════════════════════════════════════════
 RF24 radio(RF24_CE_PIN, RF24_CSN_PIN);
 
-NRF_BS2CS txPacket;
 NRF_CS2BS rxPacket;
 
 uint32_t commandsSent = 0;
 uint32_t telemetryReceived = 0;
 uint8_t commandCounter = 0;
+uint8_t session = 0;            // номер сеанса: КС отличает команды до и после перезапуска БС
+
+TxQueue txQueue;
+bool txActive = false;
+uint16_t txTestRemaining = 0;
+
+// СТАТИСТИКА ПЕРЕДАЧИ
+uint32_t txBurstStart = 0;
+uint16_t txBurstFrames = 0;
+uint16_t txBurstResent = 0;
+uint16_t txBurstDropped = 0;
+uint32_t txTotalFrames = 0;
+uint32_t txTotalUs = 0;
+uint32_t txTotalDropped = 0;
+
+// СОН КС: только по STATUS_SLEEP. Молчание — кадр о засыпании мог
+// потеряться: кадры повторяются как для спящей КС, но опрос не идёт
+bool csSleeping = false;
+bool csSilent = false;
+uint32_t lastTelemetryMs = 0;
+uint16_t csTelemetryMs = TELEMETRY_MS_DEFAULT;   // период, заданный командой TELEM; 0 — OFF
+uint16_t csWakeCount = 0;
+uint32_t csWakeLast = 0;
+uint32_t csWakeMax = 0;
+
+// ПЕРЕЗАПУСК КС: метка времени телеметрии — millis() КС от сброса
+uint32_t csLastTimestamp = 0;
+uint16_t csRestarts = 0;
+uint32_t csBootLast = 0;
+bool csBootExact = false;       // csBootLast из кадра со STATUS_BOOT, иначе — верхняя граница
+bool csLastBoot = false;
 
 // ТАЙМЕРЫ (100 мс каждый тик)
 volatile uint8_t t[6] = {0};
@@ -64,55 +105,188 @@ bool updateTimers() {
 // ══════════════════════════════════════════════════════════════
 // ОТПРАВКА КОМАНДЫ
 // ══════════════════════════════════════════════════════════════
+// Команда ставится в очередь и уходит в эфир из serviceRadioTx()
+// без ожидания подтверждения — цикл не блокируется.
 void sendCommand(uint8_t cmd, uint8_t script = 0xFF, int8_t angle_x = -99, 
                  int8_t angle_y = -99, uint16_t pwm_x = 0xFFFF, uint16_t pwm_y = 0xFFFF) {
-    commandCounter++;
-    
-    txPacket.fields.header = 0x37;
-    txPacket.fields.sat_id = 0x25;
-    txPacket.fields.packet_num = commandCounter;
-    txPacket.fields.script = script;
-    txPacket.fields.time_step = 0xFF;
-    txPacket.fields.time_telem = 0xFF;
-    txPacket.fields.pwr_servo = 0xFF;
-    txPacket.fields.pwr_laser = 0xFF;
-    txPacket.fields.pwm_x = pwm_x;
-    txPacket.fields.pwm_y = pwm_y;
+    if (txQueue.count >= TX_QUEUE_SIZE) {
+        Serial.println(F("[Radio] ERROR: TX queue full!"));
+        return;
+    }
     
-    if (angle_x != -99) {
-        txPacket.fields.pos_x = angleToNRF(angle_x);
-    } else {
-        txPacket.fields.pos_x = 0xFF;
+    NRF_BS2CS packet;
+    buildCommand(packet, session, ++commandCounter, script,
+                 angle_x != -99 ? angleToNRF(angle_x) : 0xFF,
+                 angle_y != -99 ? angleToNRF(angle_y) : 0xFF,
+                 pwm_x, pwm_y);
+    txQueuePush(txQueue, packet, cmd);
+}
+
+// Конфигурация КС: поля, равные 0xFF / CFG_NONE, не меняются
+void sendConfig(uint8_t time_step, uint8_t time_telem, uint8_t key = CFG_NONE,
+                uint16_t value = 0xFFFF, uint16_t value2 = 0xFFFF) {
+    if (txQueue.count >= TX_QUEUE_SIZE) {
+        Serial.println(F("[Radio] ERROR: TX queue full!"));
+        return;
     }
     
-    if (angle_y != -99) {
-        txPacket.fields.pos_y = angleToNRF(angle_y);
-    } else {
-        txPacket.fields.pos_y = 0xFF;
+    NRF_BS2CS packet;
+    buildConfigCommand(packet, session, ++commandCounter, time_step, time_telem, key, value, value2);
+    txQueuePush(txQueue, packet, CMD_CONFIG);
+    
+    if (time_telem != 0xFF) csTelemetryMs = time_telem * 100;
+    if (key == CFG_DEFAULTS) csTelemetryMs = TELEMETRY_MS_DEFAULT;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ПОТОКОВАЯ ПЕРЕДАЧА ЧЕРЕЗ TX FIFO
+// ══════════════════════════════════════════════════════════════
+// Учёт кадров, подтверждённых по решению txQueuePoll()
+void txConfirm(uint8_t n) {
+    while (n-- && txQueue.inFlight) {
+        TxSlot &slot = txQueuePop(txQueue);
+        commandsSent++;
+        txBurstFrames++;
+        csSilent = false;
+        
+        // Подтверждение от спящей КС — она проснулась по этому кадру
+        if (csSleeping) {
+            csSleeping = false;
+            csWakeLast = millis() - slot.firstLoad;
+            if (csWakeLast > csWakeMax) csWakeMax = csWakeLast;
+            csWakeCount++;
+            Serial.print(F("[Radio] CubeSat woke: command #"));
+            Serial.print(slot.packet.fields.packet_num);
+            Serial.print(F(" delivered in "));
+            Serial.print(csWakeLast);
+            Serial.println(F(" ms"));
+        }
+        
+        if (slot.cmd != CMD_TXTEST) {
+            Serial.print(F("[Radio] Command #"));
+            Serial.print(slot.packet.fields.packet_num);
+            Serial.print(F(" sent ("));
+            Serial.print(slot.cmd);
+            Serial.print(F(") | CRC: 0x"));
+            Serial.println(slot.packet.fields.crc, HEX);
+        }
+    }
+}
+
+void txBurstReport() {
+    uint32_t us = micros() - txBurstStart;
+    txTotalFrames += txBurstFrames;
+    txTotalUs += us;
+    txTotalDropped += txBurstDropped;
+    
+    if (txBurstFrames + txBurstDropped < 2 && !txBurstResent && !txBurstDropped) return;
+    
+    Serial.print(F("[Radio] TX burst: "));
+    Serial.print(txBurstFrames);
+    Serial.print(F(" frames in "));
+    Serial.print(us / 1000.0, 1);
+    Serial.print(F(" ms ("));
+    Serial.print(us ? txBurstFrames * 1000000.0 / us : 0.0, 0);
+    Serial.print(F(" fps) | resent "));
+    Serial.print(txBurstResent);
+    Serial.print(F(" | dropped "));
+    Serial.println(txBurstDropped);
+}
+
+void serviceRadioTx() {
+    if (txQueue.count == 0) return;
+    
+    if (!txActive) {
+        radio.stopListening();
+        txActive = true;
+        txBurstStart = micros();
+        txBurstFrames = 0;
+        txBurstResent = 0;
+        txBurstDropped = 0;
     }
     
-    // ВЫЧИСЛЯЕМ CRC
-    txPacket.fields.crc = 0;
-    txPacket.fields.crc = calculateCRC16(txPacket.raw, sizeof(txPacket.raw));
+    // ──── РЕЗУЛЬТАТ ЗАГРУЖЕННЫХ КАДРОВ ────
+    bool tx_ok, tx_fail, rx_ready;
+    radio.whatHappened(tx_ok, tx_fail, rx_ready);
     
-    // ОТПРАВЛЯЕМ
-    radio.stopListening();
-    bool success = radio.write(&txPacket, sizeof(txPacket));
-    radio.startListening();
+    TxPoll poll = txQueuePoll(txQueue, tx_ok, tx_fail, radio.isFifo(true, false), radio.isFifo(true, true),
+                              millis(), (csSleeping || csSilent) ? TX_WAKE_TIMEOUT : TX_FRAME_TIMEOUT);
+    txConfirm(poll.confirm);
     
-    if (success) {
-        commandsSent++;
-        Serial.print(F("[Radio] Command #"));
-        Serial.print(commandCounter);
-        Serial.print(F(" sent ("));
-        Serial.print(cmd);
-        Serial.print(F(") | CRC: 0x"));
-        Serial.println(txPacket.fields.crc, HEX);
-    } else {
-        Serial.println(F("[Radio] ERROR: Send failed!"));
+    // После MAX_RT FIFO очищается, неподтверждённые кадры уходят заново
+    // в прежнем порядке
+    if (poll.flush) {
+        radio.flush_tx();
+        txBurstResent += txQueue.inFlight;
+        txQueue.inFlight = 0;
+    }
+    
+    if (poll.dropHead) {
+        TxSlot &slot = txQueuePop(txQueue);
+        Serial.print(F("[Radio] ERROR: Command #"));
+        Serial.print(slot.packet.fields.packet_num);
+        Serial.println(F(" send failed!"));
+        txBurstDropped++;
+        txBurstResent--;
+    }
+    
+    // ──── ПОДПИТКА FIFO ────
+    TxSlot *next;
+    while (!radio.isFifo(true, false) && (next = txQueueLoadNext(txQueue, millis()))) {
+        radio.writeFast(&next->packet, sizeof(next->packet));
+    }
+    
+    // ──── ВОЗВРАТ В ПРИЁМ ────
+    if (txQueue.count == 0) {
+        radio.startListening();
+        txActive = false;
+        txBurstReport();
+    }
+}
+
+// ══════════════════════════════════════════════════════════════
+// ЗАМЕР СКОРОСТИ ПЕРЕДАЧИ
+// ══════════════════════════════════════════════════════════════
+// Пустые команды (все поля «не менять») подаются в очередь по мере
+// освобождения места — так же, как при загрузке программы.
+void feedTxTest() {
+    while (txTestRemaining && txQueue.count < TX_QUEUE_SIZE) {
+        NRF_BS2CS packet;
+        buildCommand(packet, session, ++commandCounter, 0xFF, 0xFF, 0xFF, 0xFFFF, 0xFFFF);
+        txQueuePush(txQueue, packet, CMD_TXTEST);
+        txTestRemaining--;
     }
 }
 
+void printTxStats() {
+    Serial.println(F("\n[Radio Stats]"));
+    Serial.print(F("  Commands sent: "));
+    Serial.println(commandsSent);
+    Serial.print(F("  Telemetry received: "));
+    Serial.println(telemetryReceived);
+    Serial.print(F("  TX dropped: "));
+    Serial.println(txTotalDropped);
+    Serial.print(F("  Sustained TX: "));
+    Serial.print(txTotalUs ? txTotalFrames * 1000000.0 / txTotalUs : 0.0, 0);
+    Serial.println(F(" fps"));
+    Serial.print(F("  CubeSat: "));
+    Serial.println(csSleeping ? F("asleep") : (csSilent ? F("silent") : F("awake")));
+    Serial.print(F("  Wake → command: last "));
+    Serial.print(csWakeLast);
+    Serial.print(F(" ms, max "));
+    Serial.print(csWakeMax);
+    Serial.print(F(" ms ("));
+    Serial.print(csWakeCount);
+    Serial.println(F(" wakes)"));
+    Serial.print(F("  CubeSat restarts: "));
+    Serial.print(csRestarts);
+    Serial.print(F(" | sketch start → telemetry: "));
+    if (!csBootExact && csRestarts) Serial.print(F("<= "));
+    Serial.print(csBootLast);
+    Serial.println(F(" ms"));
+    Serial.println();
+}
+
 // ══════════════════════════════════════════════════════════════
 // ПРИЕМ ТЕЛЕМЕТРИИ
 // ══════════════════════════════════════════════════════════════
@@ -120,17 +294,56 @@ void receiveTelemetry() {
     if (radio.available()) {
         radio.read(&rxPacket, sizeof(rxPacket));
         
-        uint16_t received_crc = rxPacket.fields.crc;
-        rxPacket.fields.crc = 0;
-        uint16_t calculated_crc = calculateCRC16(rxPacket.raw, sizeof(rxPacket.raw));
-        rxPacket.fields.crc = received_crc;
-        
-        if (calculated_crc != received_crc) {
+        uint8_t check = checkTelemetryPacket(rxPacket);
+        if (check == PACKET_BAD_CRC) {
             Serial.println(F("[Telemetry] ERROR: CRC mismatch!"));
+            if (packetLegacyCRC(rxPacket.raw)) {
+                Serial.println(F("[Telemetry] CubeSat runs the old firmware — reflash both stations"));
+            }
+            return;
+        }
+        if (check == PACKET_BAD_SAT_ID) {
+            Serial.print(F("[Telemetry] WARNING: Satellite ID 0x"));
+            Serial.print(rxPacket.fields.sat_id, HEX);
+            Serial.println(F(" is not ours"));
+            return;
+        }
+        if (check != PACKET_OK) {
+            Serial.println(F("[Telemetry] ERROR: Invalid header!"));
             return;
         }
         
         telemetryReceived++;
+        lastTelemetryMs = millis();
+        csSilent = false;
+        
+        // После сброса КС сразу шлёт телеметрию со STATUS_BOOT. Метка
+        // отсчитана от старта скетча: время загрузчика в неё не входит.
+        // Если кадр со STATUS_BOOT потерян, перезапуск виден по метке
+        // времени, а сама метка — лишь верхняя граница времени старта.
+        bool booted = (rxPacket.fields.status & STATUS_BOOT) != 0;
+        if (rxPacket.fields.timestamp < csLastTimestamp || (booted && !csLastBoot)) {
+            csRestarts++;
+            csBootLast = rxPacket.fields.timestamp;
+            csBootExact = booted;
+            Serial.print(F("[Telemetry] CubeSat restarted: first telemetry "));
+            if (!booted) Serial.print(F("<= "));
+            Serial.print(csBootLast);
+            Serial.print(F(" ms after sketch start"));
+            Serial.println(booted ? F(" (bootloader not included)") : F(" (boot frame lost)"));
+        }
+        csLastBoot = booted;
+        csLastTimestamp = rxPacket.fields.timestamp;
+        
+        bool sleeping = (rxPacket.fields.status & STATUS_SLEEP) != 0;
+        if (sleeping && !csSleeping) {
+            Serial.print(F("[Telemetry] CubeSat asleep: RX "));
+            Serial.print(SLEEP_LISTEN_WINDOW_MS);
+            Serial.print(F(" ms every "));
+            Serial.print(SLEEP_LISTEN_PERIOD_MS + SLEEP_LISTEN_WINDOW_MS);
+            Serial.println(F(" ms"));
+        }
+        csSleeping = sleeping;
         
         Serial.print(F("[Telemetry] #"));
         Serial.print(rxPacket.fields.packet_num);
@@ -144,6 +357,18 @@ void receiveTelemetry() {
         Serial.print(rxPacket.fields.pwr_laser ? "ON" : "OFF");
         Serial.print(F(" | Servo: "));
         Serial.println(rxPacket.fields.pwr_servo ? "ON" : "OFF");
+        
+        if (rxPacket.fields.acq_time != 0) {
+            Serial.print(F("[Telemetry] Target lock: "));
+            Serial.print(rxPacket.fields.acq_time * 10UL);
+            Serial.print(F(" ms | error ~"));
+            if (rxPacket.fields.acq_error != 0xFF) {
+                Serial.print(rxPacket.fields.acq_error / 10.0, 1);
+                Serial.println(F("°"));
+            } else {
+                Serial.println(F("?"));
+            }
+        }
     }
 }
 
@@ -187,8 +412,12 @@ void processSerialCommand() {
             sendCommand(CMD_DIAG2_SCAN, CMD_DIAG2_SCAN);
             Serial.println(F("→ DIAGONAL 2 SCAN ((-40,+40)→(+40,-40))"));
         }
+        else if (scanType == "7" || scanType == "ACQ") {
+            sendCommand(CMD_ACQUIRE, CMD_ACQUIRE);
+            Serial.println(F("→ ACQUIRE (coarse grid → spiral → hold on peak)"));
+        }
         else {
-            Serial.println(F("? SCAN type unknown. Use: 1/FULL, 3/HORIZ, 4/VERT, 5/DIAG1, 6/DIAG2"));
+            Serial.println(F("? SCAN type unknown. Use: 1/FULL, 3/HORIZ, 4/VERT, 5/DIAG1, 6/DIAG2, 7/ACQ"));
         }
     }
     
@@ -197,6 +426,70 @@ void processSerialCommand() {
         parsePositionCommand(input);
     }
     
+    // ──── КОМАНДА: ACQ (ЗАХВАТ ЦЕЛИ) ────
+    else if (input == "ACQ") {
+        sendCommand(CMD_ACQUIRE, CMD_ACQUIRE);
+        Serial.println(F("→ ACQUIRE (coarse grid → spiral → hold on peak)"));
+    }
+    
+    // ──── КОМАНДА: TXTEST (ЗАМЕР СКОРОСТИ) ────
+    else if (input.startsWith("TXTEST")) {
+        String countStr = input.substring(6);
+        countStr.trim();
+        long count = countStr.length() ? countStr.toInt() : 100;
+        if (count < 1 || count > 10000) {
+            Serial.println(F("? TXTEST syntax: TXTEST 100  (1 to 10000 frames)"));
+            return;
+        }
+        txTestRemaining = count;
+        Serial.print(F("→ TX TEST: "));
+        Serial.print(count);
+        Serial.println(F(" frames"));
+    }
+    
+    // ──── КОНФИГУРАЦИЯ КС ────
+    else if (input.startsWith("TELEM")) {
+        String arg = input.substring(5);
+        arg.trim();
+        long ms = (arg == "OFF") ? 0 : arg.toInt();
+        if (arg.length() == 0 || ms < 0 || ms > 25400 || (ms > 0 && ms < 100)) {
+            Serial.println(F("? TELEM syntax: TELEM 3000  (100 to 25400 ms, or OFF)"));
+            return;
+        }
+        sendConfig(0xFF, ms / 100);
+        Serial.print(F("→ TELEMETRY PERIOD "));
+        Serial.print(ms / 100 * 100);
+        Serial.println(F(" ms"));
+    }
+    
+    else if (input.startsWith("STEP")) {
+        String arg = input.substring(4);
+        arg.trim();
+        long ms = arg.toInt();
+        if (ms < 50 || ms > 2540) {
+            Serial.println(F("? STEP syntax: STEP 300  (50 to 2540 ms)"));
+            return;
+        }
+        sendConfig(ms / 10, 0xFF);
+        Serial.print(F("→ SCAN STEP "));
+        Serial.print(ms / 10 * 10);
+        Serial.println(F(" ms"));
+    }
+    
+    else if (input.startsWith("CAL")) {
+        parseCalibrationCommand(input);
+    }
+    
+    else if (input == "CONFIG DEFAULTS") {
+        sendConfig(0xFF, 0xFF, CFG_DEFAULTS);
+        Serial.println(F("→ CONFIG RESET TO FIRMWARE DEFAULTS"));
+    }
+    
+    // ──── СТАТИСТИКА ────
+    else if (input == "STATS") {
+        printTxStats();
+    }
+    
     // ──── КОМАНДА: STOP ────
     else if (input == "STOP") {
         sendCommand(CMD_STOP, CMD_STOP);
@@ -292,6 +585,35 @@ void parsePositionCommand(String input) {
     Serial.println();
 }
 
+// ══════════════════════════════════════════════════════════════
+// ПАРСЕР КОМАНДЫ CAL (КАЛИБРОВКА ПРИВОДА)
+// ══════════════════════════════════════════════════════════════
+// CAL X 1000 2000 — ШИМ (µs) при -40° и +40°
+void parseCalibrationCommand(String input) {
+    String axis = input.substring(3);
+    axis.trim();
+    String range = axis.substring(1);
+    range.trim();
+    int space = range.indexOf(' ');
+    
+    uint8_t key = axis.startsWith("X") ? CFG_SERVO_X : axis.startsWith("Y") ? CFG_SERVO_Y : CFG_NONE;
+    long minUs = space > 0 ? range.substring(0, space).toInt() : 0;
+    long maxUs = space > 0 ? range.substring(space + 1).toInt() : 0;
+    
+    if (key == CFG_NONE || minUs < 500 || maxUs > 2500 || minUs >= maxUs) {
+        Serial.println(F("? CAL syntax: CAL X 1000 2000  (µs at -40° and +40°, 500 to 2500)"));
+        return;
+    }
+    
+    sendConfig(0xFF, 0xFF, key, minUs, maxUs);
+    Serial.print(F("→ CALIBRATION "));
+    Serial.print(key == CFG_SERVO_X ? F("X: ") : F("Y: "));
+    Serial.print(minUs);
+    Serial.print(F("-"));
+    Serial.print(maxUs);
+    Serial.println(F(" µs"));
+}
+
 // ══════════════════════════════════════════════════════════════
 // СПРАВКА ПО КОМАНДАМ
 // ══════════════════════════════════════════════════════════════
@@ -306,6 +628,7 @@ void printCommandHelp() {
     Serial.println(F("  SCAN 4       (or SCAN VERT)   - Vertical scan"));
     Serial.println(F("  SCAN 5       (or SCAN DIAG1)  - Diagonal 1 scan"));
     Serial.println(F("  SCAN 6       (or SCAN DIAG2)  - Diagonal 2 scan"));
+    Serial.println(F("  ACQ          (or SCAN 7)      - Target acquisition by photodetector"));
     
     Serial.println(F("\n🎯 POSITION COMMANDS:"));
     Serial.println(F("  POS X 20          - Set X angle to 20°"));
@@ -316,6 +639,16 @@ void printCommandHelp() {
     Serial.println(F("\n⏹️  STOP COMMAND:"));
     Serial.println(F("  STOP              - Stop all systems (laser OFF, servo OFF)"));
     
+    Serial.println(F("\n💾 CUBESAT CONFIG (kept across resets):"));
+    Serial.println(F("  TELEM 3000        - Telemetry period, ms (OFF = on events only)"));
+    Serial.println(F("  STEP 300          - Scan step period, ms"));
+    Serial.println(F("  CAL X 1000 2000   - Servo PWM (µs) at -40° and +40°"));
+    Serial.println(F("  CONFIG DEFAULTS   - Restore firmware defaults"));
+    
+    Serial.println(F("\n📶 RADIO:"));
+    Serial.println(F("  TXTEST 100        - Stream 100 no-op frames, report frames/s"));
+    Serial.println(F("  STATS             - Radio counters, TX rate, CubeSat wake latency"));
+    
     Serial.println(F("\nℹ️  HELP:"));
     Serial.println(F("  HELP or ?         - Show this message"));
     Serial.println();
@@ -326,8 +659,8 @@ void printCommandHelp() {
 // ИНИЦИАЛИЗАЦИЯ
 // ══════════════════════════════════════════════════════════════
 void setup() {
+    // Монитор порта не ждём: БС работает и без USB-хоста
     Serial.begin(115200);
-    while (!Serial) {}
     
     Serial.println(F("\n════════════════════════════════════════"));
     Serial.println(F("  BASE STATION - COMMAND & CONTROL"));
@@ -347,7 +680,15 @@ void setup() {
     radio.setPayloadSize(sizeof(NRF_BS2CS));
     radio.setRetries(3, 15);
     radio.startListening();
+    txQueueReset(txQueue);
     
+    // Шум неподключённого входа АЦП и время запуска; 0xFF — значение
+    // резервного байта у прошивок без сеанса
+    randomSeed(analogRead(A0) ^ micros());
+    session = random(0, 0xFF);
+    
+    Serial.print(F("[Radio] Session 0x"));
+    Serial.println(session, HEX);
     Serial.println(F("[Radio] Ready ✓\n"));
     Serial.println(F("Commands:"));
     Serial.println(F("  1 - Full Scan"));
@@ -356,6 +697,7 @@ void setup() {
     Serial.println(F("  4 - Vertical"));
     Serial.println(F("  5 - Diagonal 1"));
     Serial.println(F("  6 - Diagonal 2"));
+    Serial.println(F("  7 - Target acquisition"));
     Serial.println(F("  x=-20 - Set X angle"));
     Serial.println(F("  y=+15 - Set Y angle\n"));
 }
@@ -368,11 +710,25 @@ void loop() {
     receiveTelemetry();
     processSerialCommand();
     
+    feedTxTest();
+    
+    // Телеметрия о засыпании могла потеряться. Без периодической
+    // телеметрии (TELEM OFF) молчание ничего не значит
+    if (!csSleeping && !csSilent && csTelemetryMs &&
+        millis() - lastTelemetryMs > (uint32_t)csTelemetryMs * TELEMETRY_SILENT_PERIODS) {
+        csSilent = true;
+        Serial.println(F("[Telemetry] CubeSat silent, may be asleep"));
+    }
+    
+    // Спящую КС опрос не будит: кадры уходят только по командам оператора
     static uint32_t last_poll = 0;
-    if (millis() - last_poll > 5000) {
+    if (!csSleeping && !csSilent && millis() - last_poll > 5000) {
         sendCommand(CMD_STOP, 0xFF);
         last_poll = millis();
     }
     
-    delay(50);
+    serviceRadioTx();
+    
+    // Во время передачи цикл не ждёт — FIFO модуля подпитывается без пауз
+    if (!txActive) delay(50);
 }
@@ -0,0 +1,106 @@
+// LinkModel.h
+// Модель радиоканала nRF24L01+: длительность кадров в эфире, тайминги
+// автоповтора (ARD/ARC) и потери по двухсостоянной модели Гилберта–Эллиота.
+#ifndef LINK_MODEL_H
+#define LINK_MODEL_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// ══════════════════════════════════════════════════════════════
+// СКОРОСТЬ И ТАЙМИНГИ РАДИОМОДУЛЯ
+// ══════════════════════════════════════════════════════════════
+enum DataRate { RATE_250K = 0, RATE_1M = 1, RATE_2M = 2 };
+
+inline const char *dataRateName(DataRate r) {
+    return r == RATE_250K ? "250K" : (r == RATE_1M ? "1M" : "2M");
+}
+
+struct RadioTiming {
+    DataRate rate;
+    uint8_t ard;          // setRetries(delay, ...) — задержка (ard+1)×250 мкс
+    uint8_t arc;          // setRetries(..., count) — число повторов
+    uint8_t payload;      // размер полезной нагрузки, байт
+
+    static const uint32_t PLL_SETTLE_US = 130;  // переход RX↔TX
+    static const uint32_t ADDRESS_BYTES = 5;
+
+    uint32_t bitRate() const {
+        return rate == RATE_250K ? 250000 : (rate == RATE_1M ? 1000000 : 2000000);
+    }
+
+    // Преамбула + адрес + 9 бит PCF + данные + CRC-16 модуля
+    uint32_t frameUs(uint8_t bytes) const {
+        uint32_t preamble = (rate == RATE_2M) ? 2 : 1;
+        uint32_t bits = 8 * (preamble + ADDRESS_BYTES + bytes + 2) + 9;
+        return (uint32_t)((uint64_t)bits * 1000000 / bitRate());
+    }
+
+    uint32_t airUs() const { return frameUs(payload); }
+    uint32_t ackUs() const { return frameUs(0); }
+    uint32_t ardUs() const { return (ard + 1u) * 250u; }
+
+    // Подтверждение успевает прийти внутри окна ARD
+    bool ackFits() const { return ardUs() >= PLL_SETTLE_US + ackUs(); }
+
+    // Период повторной передачи одного кадра
+    uint32_t attemptUs() const { return PLL_SETTLE_US + airUs() + ardUs(); }
+
+    // Задержка stopListening() библиотеки RF24 (AVR, 16 МГц)
+    uint32_t txDelayUs() const {
+        return rate == RATE_250K ? 155 : (rate == RATE_1M ? 85 : 65);
+    }
+};
+
+// ══════════════════════════════════════════════════════════════
+// ПОТЕРИ В КАНАЛЕ (ГИЛБЕРТ–ЭЛЛИОТ)
+// ══════════════════════════════════════════════════════════════
+struct ChannelProfile {
+    const char *name;
+    double lossGood;      // вероятность потери кадра в «хорошем» состоянии
+    double lossBad;       // ... в «плохом» состоянии (пачка помех)
+    double meanGoodMs;    // средняя длительность хорошего состояния
+    double meanBadMs;     // средняя длительность пачки
+};
+
+class GilbertChannel {
+public:
+    GilbertChannel(const ChannelProfile &p, std::mt19937_64 &rng) : p_(p), rng_(rng) {
+        bad_.push_back(false);
+        until_.push_back(sojourn(false));
+    }
+
+    bool badAt(uint64_t us) {
+        while (until_.back() <= us) {
+            bool next = !bad_.back();
+            uint64_t start = until_.back();
+            bad_.push_back(next);
+            until_.push_back(start + sojourn(next));
+        }
+        // Запросы почти монотонны по времени — ищем с конца
+        size_t i = until_.size() - 1;
+        while (i > 0 && until_[i - 1] > us) i--;
+        return bad_[i];
+    }
+
+    bool lost(uint64_t us) {
+        double p = badAt(us) ? p_.lossBad : p_.lossGood;
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < p;
+    }
+
+private:
+    uint64_t sojourn(bool bad) {
+        // Профиль без пачек: хорошее состояние длится бесконечно
+        if (!bad && p_.meanBadMs <= 0) return UINT64_MAX / 4;
+        double mean = (bad ? p_.meanBadMs : p_.meanGoodMs) * 1000.0;
+        return 1 + (uint64_t)std::exponential_distribution<double>(1.0 / mean)(rng_);
+    }
+
+    ChannelProfile p_;
+    std::mt19937_64 &rng_;
+    std::vector<bool> bad_;
+    std::vector<uint64_t> until_;
+};
+
+#endif
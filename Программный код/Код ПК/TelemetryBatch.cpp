@@ -0,0 +1,379 @@
+// TelemetryBatch.cpp
+#include "TelemetryBatch.h"
+
+#include <cstring>
+
+#include "../Код Cubesat/Data_Structures.h"
+
+#if defined(__x86_64__)
+#define BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+// ══════════════════════════════════════════════════════════════
+// КОНСТАНТЫ CRC
+// ══════════════════════════════════════════════════════════════
+// CRC записи — это M(x)·x^32 mod P, где M — первые 22 байта (176 бит),
+// P = x^16 + x^12 + x^5 + 1. M делится на куски по 64 бита:
+// M = c2·x^128 + c1·x^64 + c0, и каждый кусок умножается на x^(k+32) mod P.
+// Остаток 80-битной суммы сворачивается ещё раз и сводится по Барретту.
+#define CRC_POLY 0x11021u
+
+struct CrcKeys {
+    uint16_t table[256];   // байтовая таблица скалярного пути
+    uint64_t k0;           // x^32  mod P  — для c0
+    uint64_t k1;           // x^96  mod P  — для c1
+    uint64_t k2;           // x^160 mod P  — для c2
+    uint64_t k3;           // x^64  mod P  — свёртка старших бит суммы
+    uint64_t mu;           // floor(x^64 / P)
+};
+
+static uint64_t xPowMod(unsigned n) {
+    uint32_t r = 1;
+    for (unsigned i = 0; i < n; i++) {
+        r <<= 1;
+        if (r & 0x10000) r ^= CRC_POLY;
+    }
+    return r;
+}
+
+// Деление столбиком: делимое x^64 — единица и 64 нуля
+static uint64_t barrettMu() {
+    uint32_t rem = 0;
+    uint64_t q = 0;
+    for (int i = 64; i >= 0; i--) {
+        rem = (rem << 1) | (i == 64);
+        q <<= 1;
+        if (rem & 0x10000) {
+            rem ^= CRC_POLY;
+            q |= 1;
+        }
+    }
+    return q;
+}
+
+static const CrcKeys &crcKeys() {
+    static const CrcKeys keys = [] {
+        CrcKeys k;
+        // Таблица строится шагом прошивки — расхождение в алгоритме исключено
+        for (unsigned v = 0; v < 256; v++) k.table[v] = crc16_ccitt_update(0, (uint8_t)v);
+        k.k0 = xPowMod(32);
+        k.k1 = xPowMod(96);
+        k.k2 = xPowMod(160);
+        k.k3 = xPowMod(64);
+        k.mu = barrettMu();
+        return k;
+    }();
+    return keys;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ВЫБОР ПУТИ
+// ══════════════════════════════════════════════════════════════
+const char *batchPathName(BatchPath path) {
+    return path == BATCH_AVX2 ? "avx2" : (path == BATCH_SSE42 ? "sse4.2" : "scalar");
+}
+
+bool batchPathSupported(BatchPath path) {
+#ifdef BATCH_X86
+    __builtin_cpu_init();
+    bool clmul = __builtin_cpu_supports("pclmul");
+    if (path == BATCH_AVX2) return clmul && __builtin_cpu_supports("avx2");
+    if (path == BATCH_SSE42) return clmul && __builtin_cpu_supports("sse4.2");
+#endif
+    return path == BATCH_SCALAR;
+}
+
+BatchPath batchBestPath() {
+    if (batchPathSupported(BATCH_AVX2)) return BATCH_AVX2;
+    if (batchPathSupported(BATCH_SSE42)) return BATCH_SSE42;
+    return BATCH_SCALAR;
+}
+
+void TelemetryColumns::resize(size_t n) {
+    check.resize(n);
+    packetNum.resize(n);
+    lastCmdNum.resize(n);
+    timestamp.resize(n);
+    status.resize(n);
+    mode.resize(n);
+    scriptStep.resize(n);
+    pwmX.resize(n);
+    pwmY.resize(n);
+    posX.resize(n);
+    posY.resize(n);
+    pwrLaser.resize(n);
+    pwrServo.resize(n);
+    acqTime.resize(n);
+    acqError.resize(n);
+}
+
+static inline uint8_t checkResult(uint8_t header, uint8_t satId, uint16_t stored, uint16_t crc) {
+    if (header != PACKET_HEADER_TELEM) return PACKET_BAD_HEADER;
+    if (satId != PACKET_SAT_ID) return PACKET_BAD_SAT_ID;
+    if (stored != crc) return PACKET_BAD_CRC;
+    return PACKET_OK;
+}
+
+// ══════════════════════════════════════════════════════════════
+// СКАЛЯРНЫЙ ПУТЬ
+// ══════════════════════════════════════════════════════════════
+static inline uint16_t crcScalar(const uint8_t *rec, const uint16_t *table) {
+    uint16_t crc = 0;
+    for (unsigned i = 0; i < 22; i++) crc = (crc << 8) ^ table[(crc >> 8) ^ rec[i]];
+    crc = (crc << 8) ^ table[crc >> 8];
+    return (crc << 8) ^ table[crc >> 8];
+}
+
+static size_t decodeScalar(const uint8_t *records, size_t first, size_t count, TelemetryColumns &out) {
+    const uint16_t *table = crcKeys().table;
+    size_t ok = 0;
+    for (size_t i = first; i < count; i++) {
+        NRF_CS2BS p;
+        memcpy(p.raw, records + i * TELEMETRY_RECORD_SIZE, sizeof(p.raw));
+        uint8_t check = checkResult(p.fields.header, p.fields.sat_id, p.fields.crc, crcScalar(p.raw, table));
+        out.check[i] = check;
+        out.packetNum[i] = p.fields.packet_num;
+        out.lastCmdNum[i] = p.fields.last_cmd_num;
+        out.timestamp[i] = p.fields.timestamp;
+        out.status[i] = p.fields.status;
+        out.mode[i] = p.fields.mode;
+        out.scriptStep[i] = p.fields.script_step;
+        out.pwmX[i] = p.fields.pwm_x;
+        out.pwmY[i] = p.fields.pwm_y;
+        out.posX[i] = p.fields.pos_x;
+        out.posY[i] = p.fields.pos_y;
+        out.pwrLaser[i] = p.fields.pwr_laser;
+        out.pwrServo[i] = p.fields.pwr_servo;
+        out.acqTime[i] = p.fields.acq_time;
+        out.acqError[i] = p.fields.acq_error;
+        ok += check == PACKET_OK;
+    }
+    return ok;
+}
+
+#ifdef BATCH_X86
+// ══════════════════════════════════════════════════════════════
+// CRC УМНОЖЕНИЕМ БЕЗ ПЕРЕНОСОВ
+// ══════════════════════════════════════════════════════════════
+// r — байты записи 0..15, s — байты 8..23 (две загрузки без выхода за запись)
+__attribute__((target("sse4.2,pclmul")))
+static inline uint16_t crcClmul(__m128i r, __m128i s, const CrcKeys &k) {
+    // Куски M в порядке старшинства бит: младшее слово — c1, старшее — c2
+    const __m128i pickHi = _mm_setr_epi8(13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, -128, -128);
+    const __m128i pickLo = _mm_setr_epi8(13, 12, 11, 10, 9, 8, 7, 6, -128, -128, -128, -128, -128, -128, -128, -128);
+    __m128i c21 = _mm_shuffle_epi8(r, pickHi);
+    __m128i c0 = _mm_shuffle_epi8(s, pickLo);
+
+    __m128i k12 = _mm_set_epi64x((long long)k.k2, (long long)k.k1);
+    __m128i t = _mm_xor_si128(_mm_clmulepi64_si128(c21, k12, 0x00), _mm_clmulepi64_si128(c21, k12, 0x11));
+    t = _mm_xor_si128(t, _mm_clmulepi64_si128(c0, _mm_cvtsi64_si128((long long)k.k0), 0x00));
+
+    // Сумма < 2^80: старшие 16 бит сворачиваются в младшие 64
+    __m128i hi = _mm_srli_si128(t, 8);
+    t = _mm_xor_si128(_mm_move_epi64(t), _mm_clmulepi64_si128(hi, _mm_cvtsi64_si128((long long)k.k3), 0x00));
+
+    // Барретт: q = ((t >> 16)·mu) >> 48, остаток = t ^ q·P
+    __m128i q = _mm_clmulepi64_si128(_mm_srli_epi64(t, 16), _mm_cvtsi64_si128((long long)k.mu), 0x00);
+    q = _mm_srli_si128(q, 6);
+    t = _mm_xor_si128(t, _mm_clmulepi64_si128(q, _mm_cvtsi64_si128(CRC_POLY), 0x00));
+    return (uint16_t)_mm_cvtsi128_si32(t);
+}
+
+// ══════════════════════════════════════════════════════════════
+// ПЕРЕСТАНОВКА ПОЛЕЙ
+// ══════════════════════════════════════════════════════════════
+// Запись раскладывается на 6 слов по 4 байта, однотипные поля вместе:
+//   A = header, sat_id, packet_num, last_cmd_num   (из r)
+//   B = timestamp                                  (из r)
+//   C = status, mode, script_step, pos_x           (из r)
+//   D = pwm_x, pwm_y                               (из r)
+//   E = pos_y, pwr_laser, pwr_servo, acq_error     (из s)
+//   F = acq_time, crc                              (из s)
+// После транспонирования 4×4 слова одного типа от четырёх записей
+// оказываются в одном регистре и разбираются на столбцы одной перестановкой.
+#define SHUF_R  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 15, 11, 12, 13, 14
+#define SHUF_S  8, 9, 10, 13, 11, 12, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128
+#define SHUF_B4 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+#define SHUF_W2 0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15
+
+// ══════════════════════════════════════════════════════════════
+// ПУТЬ SSE4.2: 4 ЗАПИСИ ЗА ШАГ
+// ══════════════════════════════════════════════════════════════
+__attribute__((target("sse4.2,pclmul")))
+static size_t decodeSse42(const uint8_t *records, size_t count, TelemetryColumns &out) {
+    const CrcKeys &k = crcKeys();
+    const __m128i shufR = _mm_setr_epi8(SHUF_R);
+    const __m128i shufS = _mm_setr_epi8(SHUF_S);
+    const __m128i shufB4 = _mm_setr_epi8(SHUF_B4);
+    const __m128i shufW2 = _mm_setr_epi8(SHUF_W2);
+    size_t ok = 0;
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        const uint8_t *rec = records + i * TELEMETRY_RECORD_SIZE;
+        __m128i r[4], s[4], rr[4], ss[4];
+        uint16_t crc[4];
+        for (int j = 0; j < 4; j++) {
+            r[j] = _mm_loadu_si128((const __m128i *)(rec + j * TELEMETRY_RECORD_SIZE));
+            s[j] = _mm_loadu_si128((const __m128i *)(rec + j * TELEMETRY_RECORD_SIZE + 8));
+            crc[j] = crcClmul(r[j], s[j], k);
+            rr[j] = _mm_shuffle_epi8(r[j], shufR);
+            ss[j] = _mm_shuffle_epi8(s[j], shufS);
+        }
+
+        __m128i t0 = _mm_unpacklo_epi32(rr[0], rr[1]);
+        __m128i t1 = _mm_unpacklo_epi32(rr[2], rr[3]);
+        __m128i t2 = _mm_unpackhi_epi32(rr[0], rr[1]);
+        __m128i t3 = _mm_unpackhi_epi32(rr[2], rr[3]);
+        __m128i u0 = _mm_unpacklo_epi32(ss[0], ss[1]);
+        __m128i u1 = _mm_unpacklo_epi32(ss[2], ss[3]);
+
+        __m128i va = _mm_shuffle_epi8(_mm_unpacklo_epi64(t0, t1), shufB4);
+        __m128i vb = _mm_unpackhi_epi64(t0, t1);
+        __m128i vc = _mm_shuffle_epi8(_mm_unpacklo_epi64(t2, t3), shufB4);
+        __m128i vd = _mm_shuffle_epi8(_mm_unpackhi_epi64(t2, t3), shufW2);
+        __m128i ve = _mm_shuffle_epi8(_mm_unpacklo_epi64(u0, u1), shufB4);
+        __m128i vf = _mm_shuffle_epi8(_mm_unpackhi_epi64(u0, u1), shufW2);
+
+        uint8_t a[16], f[16];
+        _mm_storeu_si128((__m128i *)a, va);
+        _mm_storeu_si128((__m128i *)f, vf);
+        memcpy(&out.packetNum[i], a + 8, 4);
+        memcpy(&out.lastCmdNum[i], a + 12, 4);
+        _mm_storeu_si128((__m128i *)&out.timestamp[i], vb);
+
+        int32_t w = _mm_extract_epi32(vc, 0); memcpy(&out.status[i], &w, 4);
+        w = _mm_extract_epi32(vc, 1); memcpy(&out.mode[i], &w, 4);
+        w = _mm_extract_epi32(vc, 2); memcpy(&out.scriptStep[i], &w, 4);
+        w = _mm_extract_epi32(vc, 3); memcpy(&out.posX[i], &w, 4);
+        _mm_storel_epi64((__m128i *)&out.pwmX[i], vd);
+        _mm_storel_epi64((__m128i *)&out.pwmY[i], _mm_srli_si128(vd, 8));
+        w = _mm_extract_epi32(ve, 0); memcpy(&out.posY[i], &w, 4);
+        w = _mm_extract_epi32(ve, 1); memcpy(&out.pwrLaser[i], &w, 4);
+        w = _mm_extract_epi32(ve, 2); memcpy(&out.pwrServo[i], &w, 4);
+        w = _mm_extract_epi32(ve, 3); memcpy(&out.acqError[i], &w, 4);
+        memcpy(&out.acqTime[i], f, 8);
+
+        for (int j = 0; j < 4; j++) {
+            uint16_t stored = (uint16_t)(f[8 + 2 * j] | (f[9 + 2 * j] << 8));
+            uint8_t check = checkResult(a[j], a[4 + j], stored, crc[j]);
+            out.check[i + j] = check;
+            ok += check == PACKET_OK;
+        }
+    }
+    return ok + decodeScalar(records, i, count, out);
+}
+
+// ══════════════════════════════════════════════════════════════
+// ПУТЬ AVX2: 8 ЗАПИСЕЙ ЗА ШАГ
+// ══════════════════════════════════════════════════════════════
+// Те же перестановки в обеих половинах регистра: в младшей записи 0..3,
+// в старшей 4..7. Половины сводятся перестановкой слов при записи столбцов.
+__attribute__((target("avx2,pclmul")))
+static size_t decodeAvx2(const uint8_t *records, size_t count, TelemetryColumns &out) {
+    const CrcKeys &k = crcKeys();
+    const __m256i shufR = _mm256_broadcastsi128_si256(_mm_setr_epi8(SHUF_R));
+    const __m256i shufS = _mm256_broadcastsi128_si256(_mm_setr_epi8(SHUF_S));
+    const __m256i shufB4 = _mm256_broadcastsi128_si256(_mm_setr_epi8(SHUF_B4));
+    const __m256i shufW2 = _mm256_broadcastsi128_si256(_mm_setr_epi8(SHUF_W2));
+    const __m256i joinB4 = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t ok = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t *rec = records + i * TELEMETRY_RECORD_SIZE;
+        __m128i r[8], s[8];
+        uint16_t crc[8];
+        for (int j = 0; j < 8; j++) {
+            r[j] = _mm_loadu_si128((const __m128i *)(rec + j * TELEMETRY_RECORD_SIZE));
+            s[j] = _mm_loadu_si128((const __m128i *)(rec + j * TELEMETRY_RECORD_SIZE + 8));
+            crc[j] = crcClmul(r[j], s[j], k);
+        }
+
+        __m256i rr[4], ss[4];
+        for (int j = 0; j < 4; j++) {
+            rr[j] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(r[j]), r[j + 4], 1), shufR);
+            ss[j] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(s[j]), s[j + 4], 1), shufS);
+        }
+
+        __m256i t0 = _mm256_unpacklo_epi32(rr[0], rr[1]);
+        __m256i t1 = _mm256_unpacklo_epi32(rr[2], rr[3]);
+        __m256i t2 = _mm256_unpackhi_epi32(rr[0], rr[1]);
+        __m256i t3 = _mm256_unpackhi_epi32(rr[2], rr[3]);
+        __m256i u0 = _mm256_unpacklo_epi32(ss[0], ss[1]);
+        __m256i u1 = _mm256_unpacklo_epi32(ss[2], ss[3]);
+
+        // Байтовые столбцы: 4 слова по 8 байт, по одному на поле
+        __m256i va = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_unpacklo_epi64(t0, t1), shufB4), joinB4);
+        __m256i vc = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_unpacklo_epi64(t2, t3), shufB4), joinB4);
+        __m256i ve = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_unpacklo_epi64(u0, u1), shufB4), joinB4);
+        // 16-битные столбцы: по 128 бит на поле
+        __m256i vd = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_unpackhi_epi64(t2, t3), shufW2), 0xD8);
+        __m256i vf = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_unpackhi_epi64(u0, u1), shufW2), 0xD8);
+        __m256i vb = _mm256_unpackhi_epi64(t0, t1);
+
+        uint8_t a[32], c[32], e[32], f[32];
+        _mm256_storeu_si256((__m256i *)a, va);
+        _mm256_storeu_si256((__m256i *)c, vc);
+        _mm256_storeu_si256((__m256i *)e, ve);
+        _mm256_storeu_si256((__m256i *)f, vf);
+        memcpy(&out.packetNum[i], a + 16, 8);
+        memcpy(&out.lastCmdNum[i], a + 24, 8);
+        _mm256_storeu_si256((__m256i *)&out.timestamp[i], vb);
+        memcpy(&out.status[i], c, 8);
+        memcpy(&out.mode[i], c + 8, 8);
+        memcpy(&out.scriptStep[i], c + 16, 8);
+        memcpy(&out.posX[i], c + 24, 8);
+        _mm_storeu_si128((__m128i *)&out.pwmX[i], _mm256_castsi256_si128(vd));
+        _mm_storeu_si128((__m128i *)&out.pwmY[i], _mm256_extracti128_si256(vd, 1));
+        memcpy(&out.posY[i], e, 8);
+        memcpy(&out.pwrLaser[i], e + 8, 8);
+        memcpy(&out.pwrServo[i], e + 16, 8);
+        memcpy(&out.acqError[i], e + 24, 8);
+        memcpy(&out.acqTime[i], f, 16);
+
+        for (int j = 0; j < 8; j++) {
+            uint16_t stored = (uint16_t)(f[16 + 2 * j] | (f[17 + 2 * j] << 8));
+            uint8_t check = checkResult(a[j], a[8 + j], stored, crc[j]);
+            out.check[i + j] = check;
+            ok += check == PACKET_OK;
+        }
+    }
+    return ok + decodeScalar(records, i, count, out);
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static void crcBatchClmul(const uint8_t *records, size_t count, uint16_t *crc) {
+    const CrcKeys &k = crcKeys();
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *rec = records + i * TELEMETRY_RECORD_SIZE;
+        crc[i] = crcClmul(_mm_loadu_si128((const __m128i *)rec), _mm_loadu_si128((const __m128i *)(rec + 8)), k);
+    }
+}
+#endif
+
+// ══════════════════════════════════════════════════════════════
+// ВНЕШНИЙ ИНТЕРФЕЙС
+// ══════════════════════════════════════════════════════════════
+void batchCRC16(const uint8_t *records, size_t count, uint16_t *crc, BatchPath path) {
+    if (!batchPathSupported(path)) path = batchBestPath();
+#ifdef BATCH_X86
+    if (path != BATCH_SCALAR) {
+        crcBatchClmul(records, count, crc);
+        return;
+    }
+#endif
+    const uint16_t *table = crcKeys().table;
+    for (size_t i = 0; i < count; i++) crc[i] = crcScalar(records + i * TELEMETRY_RECORD_SIZE, table);
+}
+
+size_t decodeTelemetryBatch(const uint8_t *records, size_t count, TelemetryColumns &out, BatchPath path) {
+    if (!batchPathSupported(path)) path = batchBestPath();
+    out.resize(count);
+#ifdef BATCH_X86
+    if (path == BATCH_AVX2) return decodeAvx2(records, count, out);
+    if (path == BATCH_SSE42) return decodeSse42(records, count, out);
+#endif
+    return decodeScalar(records, 0, count, out);
+}
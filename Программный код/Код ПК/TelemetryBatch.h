@@ -0,0 +1,55 @@
+// TelemetryBatch.h
+// Пакетная проверка CRC и разбор записей телеметрии NRF_CS2BS (24 байта)
+// для наземной обработки архивов и живого потока.
+//
+// Записи лежат подряд, как в эфире. Результат — столбцы (структура
+// массивов): один вектор на поле, индекс — номер записи. Проверка
+// совпадает с checkTelemetryPacket() прошивки, включая порядок ошибок.
+//
+// Путь выбирается во время выполнения: AVX2 (8 записей за шаг),
+// SSE4.2 (4 записи) или скалярный табличный. CRC на SIMD-путях считается
+// свёрткой умножением без переносов (PCLMULQDQ).
+#ifndef TELEMETRY_BATCH_H
+#define TELEMETRY_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define TELEMETRY_RECORD_SIZE 24
+
+enum BatchPath { BATCH_SCALAR = 0, BATCH_SSE42 = 1, BATCH_AVX2 = 2 };
+
+const char *batchPathName(BatchPath path);
+bool batchPathSupported(BatchPath path);
+BatchPath batchBestPath();
+
+struct TelemetryColumns {
+    std::vector<uint8_t> check;        // PACKET_OK / PACKET_BAD_*
+    std::vector<uint8_t> packetNum;
+    std::vector<uint8_t> lastCmdNum;
+    std::vector<uint32_t> timestamp;
+    std::vector<uint8_t> status;       // STATUS_*
+    std::vector<uint8_t> mode;
+    std::vector<uint8_t> scriptStep;
+    std::vector<uint16_t> pwmX;
+    std::vector<uint16_t> pwmY;
+    std::vector<int8_t> posX;
+    std::vector<int8_t> posY;
+    std::vector<uint8_t> pwrLaser;
+    std::vector<uint8_t> pwrServo;
+    std::vector<uint16_t> acqTime;
+    std::vector<uint8_t> acqError;
+
+    void resize(size_t n);
+    size_t size() const { return check.size(); }
+};
+
+// CRC записей так же, как packetCRC16(): 22 байта и два нулевых вместо поля crc
+void batchCRC16(const uint8_t *records, size_t count, uint16_t *crc, BatchPath path);
+
+// Проверка и разбор count записей. Столбцы получают размер count.
+// Возвращает число записей с результатом PACKET_OK.
+size_t decodeTelemetryBatch(const uint8_t *records, size_t count, TelemetryColumns &out, BatchPath path);
+
+#endif
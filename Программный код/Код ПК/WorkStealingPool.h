@@ -0,0 +1,119 @@
+// WorkStealingPool.h
+// Пул потоков с захватом работы: у каждого потока своя очередь задач,
+// свободный поток забирает задачи из начала чужих очередей.
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; i++) queues_.emplace_back(new Queue);
+        for (unsigned i = 0; i < threads; i++) workers_.emplace_back(&WorkStealingPool::worker, this, i);
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread &t : workers_) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    unsigned size() const { return (unsigned)workers_.size(); }
+
+    // Задачи раскладываются по очередям потоков по кругу
+    void submit(std::function<void()> task) {
+        size_t i = next_++ % queues_.size();
+        pending_++;
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            queued_++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[i]->mutex);
+            queues_[i]->tasks.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    // Ожидание завершения всех поставленных задач
+    void wait() {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        done_.wait(lock, [this] { return pending_.load() == 0; });
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popLocal(size_t self, std::function<void()> &task) {
+        Queue &q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, std::function<void()> &task) {
+        for (size_t k = 1; k < queues_.size(); k++) {
+            Queue &q = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void worker(size_t self) {
+        for (;;) {
+            std::function<void()> task;
+            if (popLocal(self, task) || steal(self, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    queued_--;
+                }
+                task();
+                if (--pending_ == 0) {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    done_.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+            if (stop_ && queued_ == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_{0};
+    std::atomic<size_t> pending_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    long queued_ = 0;
+    bool stop_ = false;
+};
+
+#endif
@@ -0,0 +1,207 @@
+// acquisition_bench.cpp
+// Стенд захвата цели: поиск «грубая сетка → уточнение → спираль → удержание»
+// (Acquisition.cpp прошивки КС) в сравнении с полным сканированием
+// executeScanStep() при случайных положениях цели.
+//
+// Сборка:
+//   g++ -O2 -std=c++17 acquisition_bench.cpp "../Код Cubesat/Acquisition.cpp" -o acquisition_bench
+// Запуск:
+//   ./acquisition_bench [--trials N] [--seed S] [--sigma DEG] [--noise COUNTS]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../Код Cubesat/Acquisition.h"
+
+// ══════════════════════════════════════════════════════════════
+// МОДЕЛЬ СЦЕНЫ И ФОТОПРИЁМНИКА
+// ══════════════════════════════════════════════════════════════
+struct BenchConfig {
+    int trials = 2000;
+    unsigned seed = 1;
+    double beamSigma = 7.0;     // ширина отклика цели (луч + цель + поле зрения), °
+    double noiseCounts = 6.0;   // СКО шума после усреднения, отсчёты АЦП
+    double lockTolerance = 1.5; // захват засчитывается при ошибке не больше, °
+};
+
+struct Target {
+    double x;
+    double y;
+    double amplitude;           // доля полной шкалы АЦП (отражающая способность)
+};
+
+class Scene {
+public:
+    Scene(const BenchConfig &cfg, std::mt19937 &rng) : cfg_(cfg), rng_(rng), noise_(0.0, cfg.noiseCounts) {}
+
+    // Разностный отсчёт readDetector() при наведении в (x, y)
+    uint16_t detect(const Target &t, int x, int y) {
+        double dx = x - t.x;
+        double dy = y - t.y;
+        double signal = 1023.0 * t.amplitude * std::exp(-(dx * dx + dy * dy) / (2.0 * cfg_.beamSigma * cfg_.beamSigma));
+        double v = std::round(signal + noise_(rng_));
+        if (v < 0) v = 0;
+        if (v > 1023) v = 1023;
+        return (uint16_t)v;
+    }
+
+private:
+    const BenchConfig &cfg_;
+    std::mt19937 &rng_;
+    std::normal_distribution<double> noise_;
+};
+
+// ══════════════════════════════════════════════════════════════
+// ВРЕМЕННАЯ МОДЕЛЬ ПРОШИВКИ
+// ══════════════════════════════════════════════════════════════
+const double SAMPLE_MS = 2.2;        // 2×8 отсчётов analogRead + 2×200 мкс
+const double ACQ_LOOP_MS = 10.0;     // период loop() в режиме захвата
+const double SCAN_STEP_MS = 300.0;   // stateManager.stepInterval
+
+static double loopRound(double ms) {
+    return std::ceil(ms / ACQ_LOOP_MS) * ACQ_LOOP_MS;
+}
+
+struct Outcome {
+    bool locked;
+    double timeMs;
+    double errorDeg;
+    double estimateDeg;  // бортовая оценка ошибки (< 0 — нет)
+    int points;
+};
+
+// ══════════════════════════════════════════════════════════════
+// ПОИСК ПО ФОТОПРИЁМНИКУ
+// ══════════════════════════════════════════════════════════════
+static Outcome runAcquisition(Scene &scene, const Target &t, const BenchConfig &cfg) {
+    Outcome o = {false, 0.0, 0.0, -1.0, 0};
+    AcqSearch s;
+    acqStart(s);
+
+    double time = loopRound(acqDwellMs(0, 0, s.pointX, s.pointY));
+    while (s.points < 2000) {
+        int8_t fromX = s.pointX;
+        int8_t fromY = s.pointY;
+        acqFeed(s, scene.detect(t, fromX, fromY));
+        time += SAMPLE_MS;
+
+        if (s.phase == ACQ_FAILED) break;
+        if (s.phase == ACQ_HOLD) {
+            double ex = s.bestX - t.x;
+            double ey = s.bestY - t.y;
+            o.errorDeg = std::sqrt(ex * ex + ey * ey);
+            o.locked = o.errorDeg <= cfg.lockTolerance;
+            if (s.errorTenths != 0xFF) o.estimateDeg = s.errorTenths / 10.0;
+            break;
+        }
+        time += loopRound(acqDwellMs(fromX, fromY, s.pointX, s.pointY));
+    }
+    o.timeMs = time;
+    o.points = s.points;
+    return o;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ПОЛНОЕ СКАНИРОВАНИЕ (как executeScanStep)
+// ══════════════════════════════════════════════════════════════
+static std::vector<std::pair<int, int>> fullScanPoints() {
+    std::vector<std::pair<int, int>> pts;
+    for (int y = -40; y <= 40; y += 10) pts.push_back({0, y});           // HORIZ
+    for (int x = -40; x <= 40; x += 10) pts.push_back({x, 0});           // VERT
+    for (int d = -40; d <= 40; d += 10) pts.push_back({d, d});           // DIAG1
+    for (int d = -40; d <= 40; d += 10) pts.push_back({d, -d});          // DIAG2
+    return pts;
+}
+
+// Скан не анализирует отклик; для сравнения берётся лучший отсчёт за проход
+static Outcome runFullScan(Scene &scene, const Target &t, const BenchConfig &cfg) {
+    static const std::vector<std::pair<int, int>> pts = fullScanPoints();
+    Outcome o = {false, 0.0, 0.0, -1.0, 0};
+    uint16_t best = 0;
+    int bestX = 0, bestY = 0;
+    for (const auto &p : pts) {
+        uint16_t level = scene.detect(t, p.first, p.second);
+        if (level > best) {
+            best = level;
+            bestX = p.first;
+            bestY = p.second;
+        }
+        o.timeMs += SCAN_STEP_MS;
+        o.points++;
+    }
+    double ex = bestX - t.x;
+    double ey = bestY - t.y;
+    o.errorDeg = std::sqrt(ex * ex + ey * ey);
+    o.locked = best >= ACQ_DETECT_LEVEL && o.errorDeg <= cfg.lockTolerance;
+    return o;
+}
+
+// ══════════════════════════════════════════════════════════════
+// СТАТИСТИКА
+// ══════════════════════════════════════════════════════════════
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return NAN;
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)std::min<double>(v.size() - 1, std::floor(p * (v.size() - 1) + 0.5));
+    return v[i];
+}
+
+static void report(const char *name, const std::vector<Outcome> &res) {
+    std::vector<double> times, errors, estimateGap;
+    double points = 0;
+    int locked = 0;
+    for (const Outcome &o : res) {
+        points += o.points;
+        errors.push_back(o.errorDeg);
+        if (o.locked) {
+            locked++;
+            times.push_back(o.timeMs);
+        }
+        if (o.estimateDeg >= 0) estimateGap.push_back(std::fabs(o.estimateDeg - o.errorDeg));
+    }
+    printf("%-12s lock %5.1f%% | time-to-lock p50 %6.0f ms p95 %6.0f ms max %6.0f ms | "
+           "error p50 %4.2f° p95 %5.2f° | points %5.1f",
+           name, 100.0 * locked / res.size(),
+           percentile(times, 0.5), percentile(times, 0.95), percentile(times, 1.0),
+           percentile(errors, 0.5), percentile(errors, 0.95),
+           points / res.size());
+    if (!estimateGap.empty()) printf(" | |est-err| p50 %4.2f°", percentile(estimateGap, 0.5));
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    BenchConfig cfg;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--trials")) cfg.trials = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed")) cfg.seed = (unsigned)atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--sigma")) cfg.beamSigma = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--noise")) cfg.noiseCounts = atof(argv[i + 1]);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(cfg.seed);
+    std::uniform_real_distribution<double> pos(ACQ_FIELD_MIN + 2.0, ACQ_FIELD_MAX - 2.0);
+    std::uniform_real_distribution<double> amp(0.3, 1.0);
+    Scene scene(cfg, rng);
+
+    std::vector<Outcome> acq, scan;
+    for (int i = 0; i < cfg.trials; i++) {
+        Target t = {pos(rng), pos(rng), amp(rng)};
+        acq.push_back(runAcquisition(scene, t, cfg));
+        scan.push_back(runFullScan(scene, t, cfg));
+    }
+
+    printf("trials %d | beam sigma %.1f° | noise %.1f counts | lock tolerance %.1f°\n",
+           cfg.trials, cfg.beamSigma, cfg.noiseCounts, cfg.lockTolerance);
+    report("acquisition", acq);
+    report("full scan", scan);
+    return 0;
+}
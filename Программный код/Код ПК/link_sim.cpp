@@ -0,0 +1,966 @@
+// link_sim.cpp
+// Монте-Карло симулятор радиоканала и протокола БС ↔ КС.
+//
+// Тысячи независимых пар «базовая станция — CubeSat» моделируются
+// параллельно на всех ядрах (WorkStealingPool.h). Каждая пара повторяет
+// циклы loop() обеих прошивок: sendCommand()/serviceRadioTx(), processPacket(),
+// sendTelemetry(), periodicTelemetry(). Сборка команд, очередь потоковой
+// передачи БС, фильтр повторов и разбор конфигурации КС — код прошивок
+// из Protocol.h, пакеты — Data_Structures.h; всё это поверх модели nRF24L01+
+// (LinkModel.h): время в эфире, ARD/ARC, TX/RX FIFO на 3 кадра, пачки потерь.
+// КС засыпает по таймеру простоя и слушает эфир по расписанию; время
+// в режимах питания переводится в ток моделью PowerBudget.cpp прошивки.
+//
+// Сборка:
+//   g++ -O2 -std=c++17 -pthread link_sim.cpp "../Код Cubesat/PowerBudget.cpp" -o link_sim
+// Запуск:
+//   ./link_sim [--pairs N] [--duration S] [--threads T] [--seed S]
+//              [--op-rate CMD_PER_S] [--txtest N] [--power] [--csv]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "../Код Cubesat/Data_Structures.h"
+#include "../Код Cubesat/PowerBudget.h"
+#include "../Код Cubesat/Protocol.h"
+#include "LinkModel.h"
+#include "WorkStealingPool.h"
+
+// ══════════════════════════════════════════════════════════════
+// ПАРАМЕТРЫ ПРОШИВОК
+// ══════════════════════════════════════════════════════════════
+const uint64_t CS_LOOP_DELAY_US = 100000;   // delay(100) в loop() КС
+const uint64_t CS_BURST_DELAY_US = 10000;   // delay(10), пока идут команды
+const uint64_t BS_LOOP_DELAY_US = 50000;    // delay(50) в loop() БС
+const uint64_t BS_POLL_US = 5000000;        // опрос БС каждые 5 с
+const uint64_t LOOP_CPU_US = 300;           // служебная работа одной итерации
+const uint64_t PACKET_LOG_US = 6000;        // журнал пакета в Serial на 115200
+const uint64_t SPI_UPLOAD_US = 40;          // загрузка кадра в модуль по SPI
+const size_t RX_FIFO_DEPTH = 3;
+const uint32_t TX_FRAME_TIMEOUT_MS = 250;   // кадр снимается после MAX_RT по времени
+const uint64_t CS_IDLE_SLEEP_US = 30000000; // POWER_IDLE_TIMEOUT_MS
+const uint64_t CS_WAKE_US = 1100;           // пуск кварца из PWR_DOWN (16K CK) и ISR
+const uint64_t BS_SILENT_PERIODS = 3;       // TELEMETRY_SILENT_PERIODS
+const uint64_t NEVER = UINT64_MAX;
+
+// ══════════════════════════════════════════════════════════════
+// КОНФИГУРАЦИЯ ПРОГОНА
+// ══════════════════════════════════════════════════════════════
+enum TxMode { TX_BLOCKING = 0, TX_STREAMING = 1 };
+
+inline const char *txModeName(TxMode m) {
+    return m == TX_BLOCKING ? "block" : "stream";
+}
+
+struct SimConfig {
+    RadioTiming timing;
+    uint32_t telemetryMs;     // период periodicTelemetry()
+    ChannelProfile channel;
+    TxMode bsTx;              // radio.write() или очередь + writeFast()
+    uint32_t listenPeriodMs;  // SLEEP_LISTEN_PERIOD_MS; 0 — КС не засыпает
+    double operatorRate;      // действия оператора в секунду
+};
+
+struct SimParams {
+    unsigned pairs = 256;
+    double durationS = 300.0;
+    unsigned threads = 0;
+    uint64_t seed = 1;
+    double operatorRate = 0.5;  // действия оператора в секунду
+    unsigned txTest = 0;        // > 0: действие оператора — TXTEST на столько кадров
+    bool power = false;         // перебор расписания сна вместо параметров радио
+    bool csv = false;
+};
+
+// ══════════════════════════════════════════════════════════════
+// СТАТИСТИКА
+// ══════════════════════════════════════════════════════════════
+class LatencyHistogram {
+public:
+    static constexpr size_t BINS = 60000;  // шаг 1 мс, до 60 с
+
+    LatencyHistogram() : bins_(BINS + 1, 0) {}
+
+    void add(uint64_t us) {
+        bins_[std::min<uint64_t>(us / 1000, BINS)]++;
+        count_++;
+    }
+
+    void merge(const LatencyHistogram &o) {
+        for (size_t i = 0; i <= BINS; i++) bins_[i] += o.bins_[i];
+        count_ += o.count_;
+    }
+
+    double percentileMs(double p) const {
+        if (count_ == 0) return NAN;
+        uint64_t rank = (uint64_t)std::ceil(p * count_);
+        if (rank == 0) rank = 1;
+        uint64_t acc = 0;
+        for (size_t i = 0; i <= BINS; i++) {
+            acc += bins_[i];
+            if (acc >= rank) return (double)i;
+        }
+        return (double)BINS;
+    }
+
+private:
+    std::vector<uint32_t> bins_;
+    uint64_t count_ = 0;
+};
+
+struct Stats {
+    uint64_t cmdIssued = 0, cmdDelivered = 0, cmdWriteFail = 0, cmdFalseFail = 0;
+    uint64_t cmdQueueFull = 0, cmdDuplicates = 0;
+    uint64_t telIssued = 0, telDelivered = 0, telWriteFail = 0, telFalseFail = 0;
+    uint64_t writes = 0, attempts = 0, fifoDrops = 0;
+    uint64_t bytesDelivered = 0;
+    uint64_t bsBlockedUs = 0;
+    uint64_t bsTxActiveUs = 0, bsTxFrames = 0;
+    uint64_t simulatedUs = 0;
+    LatencyHistogram cmdLatency;
+    LatencyHistogram telLatency;
+    // Питание КС
+    uint64_t csModeUs[PWR_MODES] = {0};
+    uint64_t csServoUs = 0;
+    uint64_t csSleeps = 0;
+    double csMeanUASum = 0;     // сумма средних токов пар (длительность одинакова)
+    uint64_t csPairs = 0;
+    LatencyHistogram wakeLatency;  // команда, разбудившая КС: вызов → обработка
+
+    void merge(const Stats &o) {
+        cmdIssued += o.cmdIssued; cmdDelivered += o.cmdDelivered;
+        cmdWriteFail += o.cmdWriteFail; cmdFalseFail += o.cmdFalseFail;
+        cmdQueueFull += o.cmdQueueFull; cmdDuplicates += o.cmdDuplicates;
+        telIssued += o.telIssued; telDelivered += o.telDelivered;
+        telWriteFail += o.telWriteFail; telFalseFail += o.telFalseFail;
+        writes += o.writes; attempts += o.attempts; fifoDrops += o.fifoDrops;
+        bytesDelivered += o.bytesDelivered;
+        bsBlockedUs += o.bsBlockedUs;
+        bsTxActiveUs += o.bsTxActiveUs; bsTxFrames += o.bsTxFrames;
+        simulatedUs += o.simulatedUs;
+        cmdLatency.merge(o.cmdLatency);
+        telLatency.merge(o.telLatency);
+        for (int m = 0; m < PWR_MODES; m++) csModeUs[m] += o.csModeUs[m];
+        csServoUs += o.csServoUs;
+        csSleeps += o.csSleeps;
+        csMeanUASum += o.csMeanUASum;
+        csPairs += o.csPairs;
+        wakeLatency.merge(o.wakeLatency);
+    }
+};
+
+// ══════════════════════════════════════════════════════════════
+// ПАРА БС — КС
+// ══════════════════════════════════════════════════════════════
+struct Frame {
+    uint8_t raw[24];
+    uint64_t callUs;     // вызов sendCommand() / sendTelemetry()
+    uint32_t id;         // сквозной номер кадра отправителя
+    uint8_t pid;         // 2-битный PID модуля
+};
+
+// Кадр, ожидающий radio.write() (блокирующая запись)
+struct SimSlot {
+    Frame frame;
+    uint64_t firstLoadUs;  // NEVER — ещё не загружался в FIFO
+    bool delivered;      // хотя бы одна копия попала в RX FIFO приёмника
+};
+
+class PairSim {
+public:
+    PairSim(const SimConfig &cfg, const SimParams &params, uint64_t seed, Stats &stats)
+        : cfg_(cfg), params_(params), rng_(seed), channel_(cfg.channel, rng_), stats_(stats) {
+        endUs_ = (uint64_t)(params.durationS * 1e6);
+        nodes_[BS].mode = cfg.bsTx;
+        nodes_[CS].mode = TX_BLOCKING;
+        nodes_[BS].loopUs = std::uniform_int_distribution<uint64_t>(0, BS_LOOP_DELAY_US)(rng_);
+        nodes_[CS].loopUs = std::uniform_int_distribution<uint64_t>(0, CS_LOOP_DELAY_US)(rng_);
+        nextOperatorUs_ = nextOperatorGap();
+        session_ = (uint8_t)(rng_() % 0xFF);  // random(0, 0xFF) в setup() БС
+
+        // Расписание отсчитывает WDT конкретной КС: номинал ±10%
+        double wdt = std::uniform_real_distribution<double>(0.9, 1.1)(rng_);
+        periodUs_ = (uint64_t)(cfg.listenPeriodMs * 1000.0 * wdt);
+        windowUs_ = (uint64_t)(SLEEP_LISTEN_WINDOW_MS * 1000.0 * wdt);
+        wakeTimeoutMs_ = (cfg.listenPeriodMs + SLEEP_LISTEN_WINDOW_MS) * 5 / 4 + TX_FRAME_TIMEOUT_MS;
+
+        txQueueReset(bsQueue_);
+        commandFilterReset(csFilter_);
+        // Калибровку приводов оператор не меняет — её поля не моделируются
+        csDefaults_ = {(uint16_t)cfg.telemetryMs, STEP_MS_DEFAULT, 0, 0, 0, 0};
+        csConfig_ = csDefaults_;
+    }
+
+    void run() {
+        for (;;) {
+            // Ближайшее событие: цикл loop() или радиомодуль одной из сторон
+            int n = 0;
+            bool radio = false;
+            uint64_t t = NEVER;
+            for (int i = 0; i < 2; i++) {
+                if (nodes_[i].loopUs < t) { t = nodes_[i].loopUs; n = i; radio = false; }
+                if (nodes_[i].radioUs < t) { t = nodes_[i].radioUs; n = i; radio = true; }
+            }
+            if (t >= endUs_) break;
+            if (radio) radioEvent(n, t);
+            else runLoop(n, t);
+        }
+        stats_.simulatedUs += endUs_;
+        accountPower();
+    }
+
+private:
+    enum { BS = 0, CS = 1 };
+    enum RadioEvent { RADIO_FRAME_END, RADIO_ACK_END, RADIO_MAX_RT };
+
+    struct Node {
+        TxMode mode = TX_BLOCKING;
+        uint64_t loopUs = 0;                 // следующая итерация loop() (NEVER — ждёт write())
+        // Радиомодуль
+        uint64_t radioUs = NEVER;
+        RadioEvent radioEvent = RADIO_FRAME_END;
+        std::vector<std::pair<uint64_t, uint64_t>> deaf;  // интервалы без приёма
+        std::deque<Frame> rxFifo;
+        std::deque<Frame> hwFifo;            // TX FIFO модуля, голова — в эфире
+        bool maxRt = false;                  // передача остановлена по MAX_RT
+        bool txOk = false;                   // TX_DS с прошлого опроса (whatHappened())
+        bool hasLast = false;
+        uint8_t lastPid = 0;
+        uint8_t lastRaw[24];                 // CRC модуля считается по всему кадру
+        uint8_t txPid = 0;
+        uint8_t attempt = 0;
+        uint64_t attemptStart = 0;
+        // Прошивка: кадры, ждущие write() (потоковая БС — bsQueue_)
+        std::deque<SimSlot> slots;
+        bool txActive = false;
+        uint64_t txActiveSince = 0;
+        uint64_t airEndUs = 0;               // модуль закончил передачу (ACK или MAX_RT)
+        uint32_t nextFrameId = 0;
+    };
+
+    // ──── РАДИОМОДУЛЬ ────
+    bool listening(int n, uint64_t from, uint64_t to) const {
+        const Node &node = nodes_[n];
+        if (n == CS && csAsleep_ && !inListenWindow(from, to)) return false;
+        for (const auto &d : node.deaf) {
+            if (d.first < to && d.second > from) return false;
+        }
+        return true;
+    }
+
+    void stopListening(Node &node, uint64_t t) {
+        // Старые интервалы уже не влияют на приём
+        node.deaf.erase(std::remove_if(node.deaf.begin(), node.deaf.end(),
+                            [t](const std::pair<uint64_t, uint64_t> &d) { return d.second + 200000 < t; }),
+                        node.deaf.end());
+        node.deaf.push_back({t, NEVER});
+    }
+
+    void startListening(Node &node, uint64_t t) {
+        node.deaf.back().second = t + RadioTiming::PLL_SETTLE_US;
+    }
+
+    // Загрузка кадра в TX FIFO (W_TX_PAYLOAD): новый PID на каждую загрузку
+    void uploadFrame(int n, Frame f, uint64_t t) {
+        Node &node = nodes_[n];
+        f.pid = node.txPid = (node.txPid + 1) & 3;
+        node.hwFifo.push_back(f);
+        stats_.writes++;
+        if (node.hwFifo.size() == 1 && !node.maxRt) startAttempt(n, t + SPI_UPLOAD_US, true);
+    }
+
+    void startAttempt(int n, uint64_t start, bool first) {
+        Node &node = nodes_[n];
+        if (first) node.attempt = 0;
+        node.attemptStart = start;
+        node.radioEvent = RADIO_FRAME_END;
+        node.radioUs = start + RadioTiming::PLL_SETTLE_US + cfg_.timing.airUs();
+    }
+
+    void radioEvent(int n, uint64_t t) {
+        Node &node = nodes_[n];
+        Node &peer = nodes_[n ^ 1];
+        const RadioTiming &rt = cfg_.timing;
+
+        if (node.radioEvent == RADIO_ACK_END) {
+            Frame f = node.hwFifo.front();
+            node.hwFifo.pop_front();
+            node.radioUs = NEVER;
+            node.airEndUs = t;
+            if (!node.hwFifo.empty()) startAttempt(n, t, true);
+            txDone(n, f, true, t);
+            return;
+        }
+        if (node.radioEvent == RADIO_MAX_RT) {
+            node.maxRt = true;
+            node.radioUs = NEVER;
+            node.airEndUs = t;
+            txDone(n, node.hwFifo.front(), false, t);
+            return;
+        }
+
+        // RADIO_FRAME_END: кадр закончился в эфире
+        stats_.attempts++;
+        Frame &f = node.hwFifo.front();
+        bool received = listening(n ^ 1, t - rt.airUs(), t) && !channel_.lost(t - rt.airUs());
+        if (received) {
+            // Модуль отбрасывает повтор по PID и своему CRC кадра
+            bool duplicate = peer.hasLast && peer.lastPid == f.pid &&
+                             memcmp(peer.lastRaw, f.raw, sizeof(f.raw)) == 0;
+            if (!duplicate) {
+                if (peer.rxFifo.size() >= RX_FIFO_DEPTH) {
+                    // Переполненный RX FIFO отбрасывает кадр без подтверждения
+                    stats_.fifoDrops++;
+                    received = false;
+                } else {
+                    markDelivered(node, f.id);
+                    peer.rxFifo.push_back(f);
+                    peer.hasLast = true;
+                    peer.lastPid = f.pid;
+                    memcpy(peer.lastRaw, f.raw, sizeof(f.raw));
+                    // RX_DR на IRQ будит спящую КС
+                    if (n == BS && csAsleep_) wakeCubeSat(t);
+                }
+            }
+        }
+
+        if (received && rt.ackFits() && !channel_.lost(t + RadioTiming::PLL_SETTLE_US)) {
+            node.radioEvent = RADIO_ACK_END;
+            node.radioUs = t + RadioTiming::PLL_SETTLE_US + rt.ackUs();
+            return;
+        }
+        if (++node.attempt > rt.arc) {
+            node.radioEvent = RADIO_MAX_RT;
+            node.radioUs = node.attemptStart + rt.attemptUs();
+            return;
+        }
+        startAttempt(n, node.attemptStart + rt.attemptUs(), false);
+    }
+
+    void markDelivered(Node &node, uint32_t id) {
+        for (SimSlot &s : node.slots) {
+            if (s.frame.id == id) s.delivered = true;
+        }
+        if (node.mode == TX_STREAMING) {
+            for (SimSlot &s : bsSlots_) {
+                if (s.frame.id == id) s.delivered = true;
+            }
+        }
+    }
+
+    // Итог передачи головного кадра FIFO
+    void txDone(int n, const Frame &f, bool ok, uint64_t t) {
+        Node &node = nodes_[n];
+        if (node.mode == TX_STREAMING) {
+            if (ok) {
+                stats_.bsTxFrames++;
+                node.txOk = true;
+            }
+            return;  // подтверждения и MAX_RT разбирает serviceRadioTx()
+        }
+
+        // radio.write() вернул управление
+        SimSlot slot = node.slots.front();
+        node.slots.pop_front();
+        if (!ok) {
+            node.hwFifo.clear();
+            node.maxRt = false;
+            if (n == BS) stats_.cmdWriteFail++; else stats_.telWriteFail++;
+            if (slot.delivered) {
+                if (n == BS) stats_.cmdFalseFail++; else stats_.telFalseFail++;
+            }
+        }
+        if (n == BS) {
+            stats_.bsBlockedUs += t - f.callUs;
+            stats_.bsTxActiveUs += t - f.callUs;
+            if (ok) stats_.bsTxFrames++;
+        } else {
+            csRunUs_ += t - f.callUs;  // write() ждёт подтверждения в активном режиме
+        }
+
+        if (!node.slots.empty()) {
+            beginWrite(n, t + RadioTiming::PLL_SETTLE_US);
+            return;
+        }
+        startListening(node, t);
+        afterWrites(n, t);
+    }
+
+    // ──── БЛОКИРУЮЩАЯ ЗАПИСЬ: stopListening(); write(); startListening(); ────
+    void beginWrite(int n, uint64_t t) {
+        Node &node = nodes_[n];
+        SimSlot &slot = node.slots.front();
+        slot.frame.callUs = t;
+        if (node.deaf.empty() || node.deaf.back().second != NEVER) stopListening(node, t);
+        uploadFrame(n, slot.frame, t + cfg_.timing.txDelayUs());
+    }
+
+    // ──── ПОТОКОВАЯ ПЕРЕДАЧА: serviceRadioTx() прошивки БС ────
+    // Решения принимает txQueuePoll() прошивки; bsSlots_ параллелен
+    // bsQueue_.slots и хранит сведения о кадре для статистики
+    void serviceRadioTx(int n, uint64_t t) {
+        Node &node = nodes_[n];
+        if (bsQueue_.count == 0) return;
+
+        if (!node.txActive) {
+            stopListening(node, t);
+            node.txActive = true;
+            node.txActiveSince = t;
+            t += cfg_.timing.txDelayUs();
+        }
+
+        TxPoll poll = txQueuePoll(bsQueue_, node.txOk, node.maxRt, node.hwFifo.size() >= TX_HW_FIFO,
+                                  node.hwFifo.empty(), (uint32_t)(t / 1000),
+                                  bsThinksAsleep_ ? wakeTimeoutMs_ : TX_FRAME_TIMEOUT_MS);
+        node.txOk = false;
+        confirm(poll.confirm);
+
+        if (poll.flush) {
+            node.maxRt = false;
+            node.hwFifo.clear();
+            bsQueue_.inFlight = 0;
+        }
+        if (poll.dropHead) {
+            stats_.cmdWriteFail++;
+            if (bsSlots_[bsQueue_.head].delivered) stats_.cmdFalseFail++;
+            txQueuePop(bsQueue_);
+        }
+
+        TxSlot *next;
+        while (node.hwFifo.size() < TX_HW_FIFO && (next = txQueueLoadNext(bsQueue_, (uint32_t)(t / 1000)))) {
+            uploadFrame(n, bsSlots_[next - bsQueue_.slots].frame, t);
+            t += SPI_UPLOAD_US;
+        }
+
+        // Пачка кончается последним ACK/MAX_RT, а не опросом: write()
+        // тоже возвращается сразу по ACK, а до следующего loop() БС
+        // занята своим — это время не ожидание передачи
+        if (bsQueue_.count == 0) {
+            startListening(node, t);
+            node.txActive = false;
+            stats_.bsTxActiveUs += std::max(node.airEndUs, node.txActiveSince) - node.txActiveSince;
+        }
+    }
+
+    void confirm(uint8_t count) {
+        if (count && bsQueue_.inFlight) bsThinksAsleep_ = false;  // подтверждение — КС слушает
+        while (count-- && bsQueue_.inFlight) txQueuePop(bsQueue_);
+    }
+
+    // ──── ЦИКЛ loop() ────
+    void runLoop(int n, uint64_t t) {
+        Node &node = nodes_[n];
+        uint64_t cpu = LOOP_CPU_US;
+        if (n == BS) cpu += baseStationLoop(t);
+        else cpu += cubeSatLoop(t);
+        if (n == CS) csRunUs_ += cpu;
+
+        if (node.mode == TX_STREAMING) {
+            serviceRadioTx(n, t + cpu);
+            node.loopUs = t + cpu + (node.txActive ? 0 : BS_LOOP_DELAY_US);
+            return;
+        }
+        if (!node.slots.empty()) {
+            node.loopUs = NEVER;
+            beginWrite(n, t + cpu);
+        } else {
+            afterWrites(n, t + cpu);
+        }
+    }
+
+    void afterWrites(int n, uint64_t t) {
+        if (n == CS && sleepPending_) {
+            enterSleep(t);
+            return;
+        }
+        if (n == CS) {
+            // periodicTelemetry()
+            if (csConfig_.telemetryMs && t - lastTelemetryUs_ >= (uint64_t)csConfig_.telemetryMs * 1000) {
+                sendTelemetryFlag_ = true;
+                lastTelemetryUs_ = t;
+            }
+        }
+        if (n == BS) nodes_[n].loopUs = t + BS_LOOP_DELAY_US;
+        else nodes_[n].loopUs = t + (commandsArriving_ ? CS_BURST_DELAY_US : CS_LOOP_DELAY_US);
+    }
+
+    bool queueFrame(int n, const uint8_t *raw, uint64_t t) {
+        Node &node = nodes_[n];
+        SimSlot slot;
+        memcpy(slot.frame.raw, raw, sizeof(slot.frame.raw));
+        slot.frame.callUs = t;
+        slot.frame.id = node.nextFrameId++;
+        slot.frame.pid = 0;
+        slot.firstLoadUs = NEVER;
+        slot.delivered = false;
+
+        if (node.mode == TX_STREAMING) {
+            uint8_t index = (bsQueue_.head + bsQueue_.count) % TX_QUEUE_SIZE;
+            NRF_BS2CS packet;
+            memcpy(packet.raw, raw, sizeof(packet.raw));
+            if (!txQueuePush(bsQueue_, packet, 0)) return false;
+            bsSlots_[index] = slot;
+            return true;
+        }
+        node.slots.push_back(slot);
+        return true;
+    }
+
+    // receiveTelemetry() + processSerialCommand() + опрос
+    uint64_t baseStationLoop(uint64_t t) {
+        Node &node = nodes_[BS];
+        uint64_t cpu = 0;
+
+        if (!node.rxFifo.empty()) {
+            Frame f = node.rxFifo.front();
+            node.rxFifo.pop_front();
+            NRF_CS2BS rxPacket;
+            memcpy(rxPacket.raw, f.raw, sizeof(rxPacket.raw));
+            if (checkTelemetryPacket(rxPacket) == PACKET_OK) {
+                stats_.telDelivered++;
+                stats_.bytesDelivered += sizeof(rxPacket.raw);
+                stats_.telLatency.add(t - f.callUs);
+                bsLastTelemetryUs_ = t;
+                bsThinksAsleep_ = (rxPacket.fields.status & STATUS_SLEEP) != 0;
+            }
+            cpu += PACKET_LOG_US;
+        }
+
+        // Действие оператора: POS / SCAN / TELEM ... либо TXTEST N.
+        // TELEM повторяет период прогона — конфигурация КС проходит разбор
+        // прошивки, но период телеметрии остаётся заданным
+        if (t >= nextOperatorUs_) {
+            if (params_.txTest) {
+                txTestRemaining_ += params_.txTest;
+            } else {
+                std::uniform_int_distribution<int> angle(0, 80);
+                uint64_t action = rng_() % 8;
+                if (action == 0) queueConfig(t, (uint8_t)(cfg_.telemetryMs / 100));
+                else if (action & 1) queueCommand(t, 0xFF, angle(rng_), angle(rng_));
+                else queueCommand(t, 1 + rng_() % 7, 0xFF, 0xFF);
+            }
+            nextOperatorUs_ = t + nextOperatorGap();
+            cpu += PACKET_LOG_US;
+        }
+
+        // feedTxTest(): пустые команды по мере места в очереди;
+        // при блокирующей записи — все сразу, подряд вызовами write()
+        while (txTestRemaining_ && (node.mode == TX_BLOCKING || bsQueue_.count < TX_QUEUE_SIZE)) {
+            queueCommand(t, 0xFF, 0xFF, 0xFF);
+            txTestRemaining_--;
+        }
+
+        // Молчание дольше трёх периодов телеметрии (csSilent прошивки БС)
+        if (!bsThinksAsleep_ && t - bsLastTelemetryUs_ > BS_SILENT_PERIODS * cfg_.telemetryMs * 1000) {
+            bsThinksAsleep_ = true;
+        }
+
+        // Спящую КС опрос не будит
+        if (!bsThinksAsleep_ && t - lastPollUs_ > BS_POLL_US) {
+            queueCommand(t, 0xFF, 0xFF, 0xFF);
+            lastPollUs_ = t;
+        }
+        return cpu;
+    }
+
+    // sendCommand() / sendConfig() прошивки БС
+    void queueCommand(uint64_t t, uint8_t script, uint8_t pos_x, uint8_t pos_y) {
+        NRF_BS2CS txPacket;
+        buildCommand(txPacket, session_, ++commandCounter_, script, pos_x, pos_y, 0xFFFF, 0xFFFF);
+        issueCommand(txPacket, t);
+    }
+
+    void queueConfig(uint64_t t, uint8_t time_telem) {
+        NRF_BS2CS txPacket;
+        buildConfigCommand(txPacket, session_, ++commandCounter_, 0xFF, time_telem, CFG_NONE, 0xFFFF, 0xFFFF);
+        issueCommand(txPacket, t);
+    }
+
+    void issueCommand(const NRF_BS2CS &txPacket, uint64_t t) {
+        if (queueFrame(BS, txPacket.raw, t)) stats_.cmdIssued++;
+        else stats_.cmdQueueFull++;
+    }
+
+    // receivePackets() + processPacket() до опустошения RX FIFO, sendTelemetry()
+    uint64_t cubeSatLoop(uint64_t t) {
+        Node &node = nodes_[CS];
+        uint64_t cpu = 0;
+
+        commandsArriving_ = !node.rxFifo.empty();
+        while (!node.rxFifo.empty()) {
+            Frame f = node.rxFifo.front();
+            node.rxFifo.pop_front();
+            NRF_BS2CS rxPacket;
+            memcpy(rxPacket.raw, f.raw, sizeof(rxPacket.raw));
+            cpu += PACKET_LOG_US;
+
+            if (checkCommandPacket(rxPacket) == PACKET_OK) {
+                if (commandFilterSeen(csFilter_, rxPacket.fields.session, rxPacket.fields.packet_num)) {
+                    stats_.cmdDuplicates++;
+                } else {
+                    stats_.cmdDelivered++;
+                    stats_.bytesDelivered += sizeof(rxPacket.raw);
+                    stats_.cmdLatency.add(t + cpu - f.callUs);
+                    // powerCommandReceived()
+                    if (wokeByRadio_) {
+                        stats_.wakeLatency.add(t + cpu - f.callUs);
+                        wokeByRadio_ = false;
+                    }
+
+                    bool changesMade = commandHasActions(rxPacket);
+                    if (changesMade) setServo(true, t);  // перемещение подключает приводы
+
+                    // storageApplyCommand() без записи в EEPROM
+                    CubeSatConfig c = csConfig_;
+                    configApplyCommand(c, rxPacket, csDefaults_);
+                    if (memcmp(&c, &csConfig_, sizeof(c)) != 0) {
+                        csConfig_ = c;
+                        changesMade = true;
+                    }
+
+                    lastPacketNumber_ = rxPacket.fields.packet_num;
+                    if (changesMade) {
+                        sendTelemetryFlag_ = true;
+                        lastActivityUs_ = t;      // powerActivity()
+                    }
+                }
+            }
+        }
+
+        // powerIdleExpired(): телеметрия с STATUS_SLEEP, затем сон в afterWrites()
+        if (cfg_.listenPeriodMs && t - lastActivityUs_ >= CS_IDLE_SLEEP_US && node.rxFifo.empty()) {
+            sleepPending_ = true;
+            sendTelemetryFlag_ = true;
+        }
+
+        if (sendTelemetryFlag_) {
+            sendTelemetryFlag_ = false;
+            NRF_CS2BS txPacket;
+            memset(&txPacket, 0, sizeof(txPacket));
+            txPacket.fields.last_cmd_num = lastPacketNumber_;
+            txPacket.fields.timestamp = (uint32_t)(t / 1000);
+            txPacket.fields.status = STATUS_PACKET_LEN_OK | STATUS_CRC_OK | (sleepPending_ ? STATUS_SLEEP : 0);
+            sealTelemetryPacket(txPacket, ++telemetryCounter_);
+            queueFrame(CS, txPacket.raw, t);
+            stats_.telIssued++;
+        }
+        return cpu;
+    }
+
+    uint64_t nextOperatorGap() {
+        if (cfg_.operatorRate <= 0) return NEVER / 4;
+        return 1 + (uint64_t)std::exponential_distribution<double>(cfg_.operatorRate / 1e6)(rng_);
+    }
+
+    // ──── ПИТАНИЕ КС: powerSleep() ────
+    // Окно приёма — в конце каждого цикла WDT, после пуска МК и PLL модуля
+    bool inListenWindow(uint64_t from, uint64_t to) const {
+        uint64_t cycle = periodUs_ + windowUs_;
+        uint64_t phase = (from - csSegmentUs_) % cycle;
+        return phase >= periodUs_ + CS_WAKE_US + RadioTiming::PLL_SETTLE_US && phase + (to - from) <= cycle;
+    }
+
+    void setServo(bool on, uint64_t t) {
+        if (servoOn_) pairServoUs_ += t - servoSinceUs_;
+        servoOn_ = on;
+        servoSinceUs_ = t;
+    }
+
+    // Бодрствование: RUN — работа цикла и ожидание write(), остальное — powerDelay()
+    void closeAwake(uint64_t t) {
+        uint64_t awake = t - csSegmentUs_;
+        uint64_t run = std::min(csRunUs_, awake);
+        pairModeUs_[PWR_RUN] += run;
+        pairModeUs_[PWR_IDLE] += awake - run;
+        csRunUs_ = 0;
+        csSegmentUs_ = t;
+    }
+
+    void closeSleep(uint64_t t) {
+        uint64_t slept = t - csSegmentUs_;
+        uint64_t cycle = periodUs_ + windowUs_;
+        uint64_t rest = slept % cycle;
+        uint64_t listen = slept / cycle * windowUs_ + (rest > periodUs_ ? rest - periodUs_ : 0);
+        pairModeUs_[PWR_LISTEN] += listen;
+        pairModeUs_[PWR_STANDBY] += slept - listen;
+        csSegmentUs_ = t;
+    }
+
+    void enterSleep(uint64_t t) {
+        sleepPending_ = false;
+        closeAwake(t);
+        setServo(false, t);
+        csAsleep_ = true;
+        nodes_[CS].loopUs = NEVER;
+        stats_.csSleeps++;
+    }
+
+    void wakeCubeSat(uint64_t t) {
+        closeSleep(t);
+        csAsleep_ = false;
+        wokeByRadio_ = true;
+        lastActivityUs_ = t;
+        sendTelemetryFlag_ = true;
+        lastTelemetryUs_ = t;
+        nodes_[CS].loopUs = t + CS_WAKE_US;
+    }
+
+    void accountPower() {
+        if (csAsleep_) closeSleep(endUs_);
+        else closeAwake(endUs_);
+        setServo(servoOn_, endUs_);
+
+        PowerBudget budget;
+        powerBudgetReset(budget);
+        for (int m = 0; m < PWR_MODES; m++) {
+            budget.modeMs[m] = (uint32_t)(pairModeUs_[m] / 1000);
+            stats_.csModeUs[m] += pairModeUs_[m];
+        }
+        budget.servoMs = (uint32_t)(pairServoUs_ / 1000);
+        stats_.csServoUs += pairServoUs_;
+        stats_.csMeanUASum += powerMeanCurrentUA(budget);
+        stats_.csPairs++;
+    }
+
+    const SimConfig &cfg_;
+    const SimParams &params_;
+    std::mt19937_64 rng_;
+    GilbertChannel channel_;
+    Stats &stats_;
+    Node nodes_[2];
+    uint64_t endUs_ = 0;
+
+    // Состояние прошивки БС
+    TxQueue bsQueue_;
+    SimSlot bsSlots_[TX_QUEUE_SIZE];
+    uint8_t commandCounter_ = 0;
+    uint8_t session_ = 0;
+    uint64_t lastPollUs_ = 0;
+    uint64_t nextOperatorUs_ = 0;
+    unsigned txTestRemaining_ = 0;
+
+    // Состояние прошивки КС
+    uint8_t telemetryCounter_ = 0;
+    uint8_t lastPacketNumber_ = 0;
+    bool sendTelemetryFlag_ = true;
+    bool commandsArriving_ = false;
+    uint64_t lastTelemetryUs_ = 0;
+    CommandFilter csFilter_;
+    CubeSatConfig csConfig_;
+    CubeSatConfig csDefaults_;
+
+    // Питание КС
+    uint64_t periodUs_ = 0, windowUs_ = 0;
+    uint32_t wakeTimeoutMs_ = 0;
+    bool csAsleep_ = false;
+    bool sleepPending_ = false;
+    bool wokeByRadio_ = false;
+    uint64_t lastActivityUs_ = 0;
+    uint64_t csSegmentUs_ = 0;        // начало текущего бодрствования или сна
+    uint64_t csRunUs_ = 0;
+    bool servoOn_ = true;             // actuatorsSetup() подключает приводы
+    uint64_t servoSinceUs_ = 0;
+    uint64_t pairModeUs_[PWR_MODES] = {0};
+    uint64_t pairServoUs_ = 0;
+
+    // Сон КС глазами БС
+    bool bsThinksAsleep_ = false;
+    uint64_t bsLastTelemetryUs_ = 0;
+};
+
+// ══════════════════════════════════════════════════════════════
+// ПЕРЕБОР КОНФИГУРАЦИЙ
+// ══════════════════════════════════════════════════════════════
+static const ChannelProfile CHANNELS[] = {
+    {"clean",  0.01, 0.01, 0.0,    0.0},
+    {"bursty", 0.02, 0.60, 2000.0, 60.0},
+    {"harsh",  0.10, 0.90, 500.0,  150.0},
+};
+
+static std::vector<SimConfig> buildSweep(const SimParams &params) {
+    const DataRate rates[] = {RATE_250K, RATE_1M, RATE_2M};
+    const uint8_t retries[][2] = {{3, 15}, {1, 5}, {5, 3}, {15, 15}};
+    const uint32_t telemetry[] = {1000, 3000};
+    const uint8_t payloads[] = {24, 32};
+    const TxMode modes[] = {TX_BLOCKING, TX_STREAMING};
+
+    std::vector<SimConfig> sweep;
+    for (const ChannelProfile &ch : CHANNELS)
+        for (DataRate r : rates)
+            for (const auto &rt : retries)
+                for (uint32_t tm : telemetry)
+                    for (uint8_t pl : payloads)
+                        for (TxMode m : modes)
+                            sweep.push_back({{r, rt[0], rt[1], pl}, tm, ch, m,
+                                             SLEEP_LISTEN_PERIOD_MS, params.operatorRate});
+    return sweep;
+}
+
+// Радио и телеметрия — как в прошивках; перебираются цикл приёма спящей
+// КС (0 — без сна) и частота действий оператора
+static std::vector<SimConfig> buildPowerSweep(const SimParams &params, bool opRateSet) {
+    const uint32_t periods[] = {0, 250, 500, 1000, 2000, 4000};
+    std::vector<double> opRates = {1.0 / 30, 1.0 / 120, 1.0 / 600};
+    if (opRateSet) opRates = {params.operatorRate};
+
+    std::vector<SimConfig> sweep;
+    for (const ChannelProfile &ch : CHANNELS)
+        for (uint32_t period : periods)
+            for (double op : opRates)
+                sweep.push_back({{RATE_250K, 3, 15, 24}, 3000, ch, TX_STREAMING, period, op});
+    return sweep;
+}
+
+static uint64_t mixSeed(uint64_t a, uint64_t b, uint64_t c) {
+    uint64_t x = a * 0x9E3779B97F4A7C15ull ^ (b + 0x632BE59BD9B4E019ull) * 0xBF58476D1CE4E5B9ull ^ c * 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x * 0xD6E8FEB86659FD93ull;
+}
+
+static void printRow(const SimConfig &c, const Stats &s, bool csv) {
+    double seconds = s.simulatedUs / 1e6;
+    uint64_t cmdOffered = s.cmdIssued + s.cmdQueueFull;
+    double cmdLoss = cmdOffered ? 100.0 * (cmdOffered - s.cmdDelivered) / cmdOffered : 0;
+    double telLoss = s.telIssued ? 100.0 * (s.telIssued - s.telDelivered) / s.telIssued : 0;
+    double falseFail = s.cmdWriteFail ? 100.0 * s.cmdFalseFail / s.cmdWriteFail : 0;
+    double attempts = s.writes ? (double)s.attempts / s.writes : 0;
+    double goodput = seconds > 0 ? s.bytesDelivered / seconds : 0;
+    double blocked = seconds > 0 ? s.bsBlockedUs / 1000.0 / seconds : 0;
+    double txFps = s.bsTxActiveUs ? s.bsTxFrames * 1e6 / s.bsTxActiveUs : 0;
+
+    if (csv) {
+        printf("%s,%s,%u,%u,%u,%u,%s,%.3f,%.1f,%.1f,%.1f,%.3f,%.3f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.1f,%llu,%llu\n",
+               c.channel.name, dataRateName(c.timing.rate), c.timing.ard, c.timing.arc, c.telemetryMs,
+               c.timing.payload, txModeName(c.bsTx), cmdLoss,
+               s.cmdLatency.percentileMs(0.5), s.cmdLatency.percentileMs(0.95), s.cmdLatency.percentileMs(0.99),
+               telLoss, falseFail,
+               s.telLatency.percentileMs(0.5), s.telLatency.percentileMs(0.95), s.telLatency.percentileMs(0.99),
+               goodput, attempts, blocked, txFps,
+               (unsigned long long)s.fifoDrops, (unsigned long long)s.cmdDuplicates);
+        return;
+    }
+    printf("%-6s %-4s %2u/%-2u %4u %2u %-6s | %6.2f%% %5.0f %5.0f %5.0f | %6.2f%% %5.0f %5.0f %5.0f | "
+           "%5.1f%% | %6.1f | %4.2f | %6.2f | %5.0f\n",
+           c.channel.name, dataRateName(c.timing.rate), c.timing.ard, c.timing.arc, c.telemetryMs,
+           c.timing.payload, txModeName(c.bsTx), cmdLoss,
+           s.cmdLatency.percentileMs(0.5), s.cmdLatency.percentileMs(0.95), s.cmdLatency.percentileMs(0.99),
+           telLoss,
+           s.telLatency.percentileMs(0.5), s.telLatency.percentileMs(0.95), s.telLatency.percentileMs(0.99),
+           falseFail, goodput, attempts, blocked, txFps);
+}
+
+static void printPowerRow(const SimConfig &c, const Stats &s, bool csv) {
+    double hours = s.simulatedUs / 3.6e9;
+    uint64_t cmdOffered = s.cmdIssued + s.cmdQueueFull;
+    double cmdLoss = cmdOffered ? 100.0 * (cmdOffered - s.cmdDelivered) / cmdOffered : 0;
+    uint64_t total = 0;
+    for (int m = 0; m < PWR_MODES; m++) total += s.csModeUs[m];
+    auto pct = [total](uint64_t us) { return total ? 100.0 * us / total : 0.0; };
+    double asleep = pct(s.csModeUs[PWR_LISTEN] + s.csModeUs[PWR_STANDBY]);
+    uint32_t meanUA = s.csPairs ? (uint32_t)(s.csMeanUASum / s.csPairs) : 0;
+    double sleepsPerHour = hours > 0 ? s.csSleeps / hours : 0;
+
+    if (csv) {
+        printf("%s,%u,%.1f,%.3f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f,%.2f,%.2f,%.3f,%.2f\n",
+               c.channel.name, c.listenPeriodMs, c.operatorRate * 3600, cmdLoss,
+               s.cmdLatency.percentileMs(0.5), s.cmdLatency.percentileMs(0.99), sleepsPerHour,
+               s.wakeLatency.percentileMs(0.5), s.wakeLatency.percentileMs(0.95), s.wakeLatency.percentileMs(0.99),
+               asleep, pct(s.csModeUs[PWR_LISTEN]), pct(s.csServoUs), meanUA / 1000.0,
+               powerEnergyPerHourMWh(meanUA));
+        return;
+    }
+    printf("%-6s %5u %5.0f | %6.2f%% %5.0f %5.0f | %6.1f | %5.0f %5.0f %5.0f | %5.1f%% %4.1f%% %5.1f%% | %7.3f | %7.2f\n",
+           c.channel.name, c.listenPeriodMs, c.operatorRate * 3600, cmdLoss,
+           s.cmdLatency.percentileMs(0.5), s.cmdLatency.percentileMs(0.99), sleepsPerHour,
+           s.wakeLatency.percentileMs(0.5), s.wakeLatency.percentileMs(0.95), s.wakeLatency.percentileMs(0.99),
+           asleep, pct(s.csModeUs[PWR_LISTEN]), pct(s.csServoUs), meanUA / 1000.0,
+           powerEnergyPerHourMWh(meanUA));
+}
+
+int main(int argc, char **argv) {
+    SimParams params;
+    bool pairsSet = false, durationSet = false, opRateSet = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--csv")) params.csv = true;
+        else if (!strcmp(argv[i], "--power")) params.power = true;
+        else if (i + 1 < argc && !strcmp(argv[i], "--pairs")) { params.pairs = (unsigned)atoi(argv[++i]); pairsSet = true; }
+        else if (i + 1 < argc && !strcmp(argv[i], "--duration")) { params.durationS = atof(argv[++i]); durationSet = true; }
+        else if (i + 1 < argc && !strcmp(argv[i], "--threads")) params.threads = (unsigned)atoi(argv[++i]);
+        else if (i + 1 < argc && !strcmp(argv[i], "--seed")) params.seed = strtoull(argv[++i], nullptr, 10);
+        else if (i + 1 < argc && !strcmp(argv[i], "--op-rate")) { params.operatorRate = atof(argv[++i]); opRateSet = true; }
+        else if (i + 1 < argc && !strcmp(argv[i], "--txtest")) params.txTest = (unsigned)atoi(argv[++i]);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Энергия считается за час: сон длится минуты, прогоны длиннее
+    if (params.power) {
+        if (!pairsSet) params.pairs = 64;
+        if (!durationSet) params.durationS = 3600.0;
+    }
+
+    std::vector<SimConfig> sweep = params.power ? buildPowerSweep(params, opRateSet) : buildSweep(params);
+    std::vector<Stats> results(sweep.size());
+    std::vector<std::unique_ptr<std::mutex>> locks;
+    for (size_t i = 0; i < sweep.size(); i++) locks.emplace_back(new std::mutex);
+
+    WorkStealingPool pool(params.threads ? params.threads : std::thread::hardware_concurrency());
+    const unsigned CHUNK = 8;
+
+    auto started = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < sweep.size(); c++) {
+        for (unsigned first = 0; first < params.pairs; first += CHUNK) {
+            pool.submit([&, c, first] {
+                std::unique_ptr<Stats> local(new Stats);
+                unsigned last = std::min(params.pairs, first + CHUNK);
+                for (unsigned p = first; p < last; p++) {
+                    PairSim sim(sweep[c], params, mixSeed(params.seed, c, p), *local);
+                    sim.run();
+                }
+                std::lock_guard<std::mutex> lock(*locks[c]);
+                results[c].merge(*local);
+            });
+        }
+    }
+    pool.wait();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    if (params.power) {
+        if (params.csv) {
+            printf("channel,listen_period_ms,op_per_h,cmd_loss_pct,cmd_p50_ms,cmd_p99_ms,sleeps_per_h,"
+                   "wake_p50_ms,wake_p95_ms,wake_p99_ms,asleep_pct,listen_pct,servo_pct,mean_mA,mWh_per_h\n");
+        } else {
+            printf("%u pairs × %.0f s × %zu configs on %u threads, %.1f s wall, RX window %u ms\n\n",
+                   params.pairs, params.durationS, sweep.size(), pool.size(), elapsed, SLEEP_LISTEN_WINDOW_MS);
+            printf("chan   period op/h |  cmd loss   p50   p99 | slp/h  |  wake p50   p95   p99 | "
+                   "asleep listen servo |  mean mA | mWh/h\n");
+        }
+        for (size_t c = 0; c < sweep.size(); c++) printPowerRow(sweep[c], results[c], params.csv);
+        return 0;
+    }
+
+    if (params.csv) {
+        printf("channel,rate,ard,arc,telemetry_ms,payload,bs_tx,cmd_loss_pct,cmd_p50_ms,cmd_p95_ms,cmd_p99_ms,"
+               "tel_loss_pct,cmd_false_fail_pct,tel_p50_ms,tel_p95_ms,tel_p99_ms,goodput_Bps,"
+               "attempts_per_frame,bs_blocked_ms_per_s,bs_tx_fps,fifo_drops,cmd_duplicates\n");
+    } else {
+        printf("%u pairs × %.0f s × %zu configs on %u threads, %.1f s wall, op-rate %.2f, txtest %u\n\n",
+               params.pairs, params.durationS, sweep.size(), pool.size(), elapsed,
+               params.operatorRate, params.txTest);
+        printf("chan   rate ard/arc telem pl bs tx  |  cmd loss   p50   p95   p99 |  tel loss   p50   p95   p99 | "
+               "falseF | goodput B/s | att | BS blk ms/s | TX fps\n");
+    }
+    for (size_t c = 0; c < sweep.size(); c++) printRow(sweep[c], results[c], params.csv);
+    return 0;
+}
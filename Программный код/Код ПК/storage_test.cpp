@@ -0,0 +1,235 @@
+// storage_test.cpp
+// Проверка колец записей EEPROM прошивки (StorageRing.cpp) на модели
+// памяти ATmega328P: выбор новейшей записи при переполнении seq,
+// прерванная и испорченная запись, износ ячеек и решение о возобновлении
+// режима после сброса по провалу питания (BORF без PORF).
+//
+// Сборка:
+//   g++ -O2 -std=c++17 storage_test.cpp "../Код Cubesat/StorageRing.cpp" -o storage_test
+// Запуск:
+//   ./storage_test
+// Код выхода 1 — хотя бы одна проверка не прошла.
+
+#include <cstdio>
+#include <cstring>
+
+#include "../Код Cubesat/Data_Structures.h"
+#include "../Код Cubesat/StateMachine.h"
+#include "../Код Cubesat/StorageRing.h"
+
+// ══════════════════════════════════════════════════════════════
+// МОДЕЛЬ EEPROM
+// ══════════════════════════════════════════════════════════════
+// 1 КБ, стёртые ячейки — 0xFF. tornAfter: после стольких записанных
+// байт питание «пропадает» — остальные update() не доходят до памяти.
+const uint16_t EEPROM_BYTES = 1024;
+
+static uint8_t memory[EEPROM_BYTES];
+static uint32_t wear[EEPROM_BYTES];
+static long tornAfter = -1;
+
+static uint8_t memRead(uint16_t addr) {
+    return memory[addr];
+}
+
+static void memUpdate(uint16_t addr, uint8_t value) {
+    if (memory[addr] == value) return;
+    if (tornAfter == 0) return;
+    if (tornAfter > 0) tornAfter--;
+    memory[addr] = value;
+    wear[addr]++;
+}
+
+static const StorageMemory mem = {memRead, memUpdate};
+
+static void eraseMemory() {
+    memset(memory, 0xFF, sizeof(memory));
+    memset(wear, 0, sizeof(wear));
+    tornAfter = -1;
+}
+
+// Кольца с разметкой Storage.cpp
+static StorageRing configRing() {
+    StorageRing r = {STORAGE_CONFIG_BASE, STORAGE_CONFIG_SLOTS, sizeof(CubeSatConfig), STORAGE_CONFIG_ID, 0, 0, false};
+    return r;
+}
+
+static StorageRing stateRing() {
+    StorageRing r = {STORAGE_CONFIG_BASE + STORAGE_RING_BYTES(STORAGE_CONFIG_SLOTS, sizeof(CubeSatConfig)),
+                     STORAGE_STATE_SLOTS, sizeof(CubeSatSnapshot), STORAGE_STATE_ID, 0, 0, false};
+    return r;
+}
+
+static CubeSatSnapshot snapshot(uint8_t mode, uint8_t step) {
+    CubeSatSnapshot s;
+    memset(&s, 0, sizeof(s));
+    s.mode = mode;
+    s.step = step;
+    return s;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ПРОВЕРКИ
+// ══════════════════════════════════════════════════════════════
+static int failures = 0;
+
+static void expect(bool ok, const char *what) {
+    if (ok) return;
+    failures++;
+    fprintf(stderr, "FAIL %s\n", what);
+}
+
+static void testLayout() {
+    uint32_t end = stateRing().base + STORAGE_RING_BYTES(STORAGE_STATE_SLOTS, sizeof(CubeSatSnapshot));
+    expect(end <= EEPROM_BYTES, "layout fits 1 KB EEPROM");
+    printf("layout: config %u B, state %u B, %u of %u B used\n",
+           (unsigned)STORAGE_RING_BYTES(STORAGE_CONFIG_SLOTS, sizeof(CubeSatConfig)),
+           (unsigned)STORAGE_RING_BYTES(STORAGE_STATE_SLOTS, sizeof(CubeSatSnapshot)),
+           (unsigned)end, (unsigned)EEPROM_BYTES);
+}
+
+static void testEmpty() {
+    eraseMemory();
+    StorageRing ring = stateRing();
+    CubeSatSnapshot s;
+    expect(!storageRingLoad(mem, ring, &s), "erased EEPROM has no record");
+}
+
+// Каждая запись загружается обратно, износ делится на все ячейки
+static void testRoundTripAndWear() {
+    eraseMemory();
+    StorageRing ring = stateRing();
+    const unsigned SAVES = 1000;
+
+    for (unsigned i = 0; i < SAVES; i++) {
+        CubeSatSnapshot s = snapshot(STATE_SCAN_HORIZONTAL, (uint8_t)i);
+        storageRingSave(mem, ring, &s);
+
+        StorageRing loaded = stateRing();
+        CubeSatSnapshot back;
+        if (!storageRingLoad(mem, loaded, &back) || back.step != (uint8_t)i || loaded.seq != ring.seq) {
+            expect(false, "newest record loaded after each save");
+            return;
+        }
+    }
+
+    uint32_t maxWear = 0;
+    for (uint16_t a = ring.base; a < ring.base + STORAGE_RING_BYTES(ring.slots, ring.size); a++) {
+        if (wear[a] > maxWear) maxWear = wear[a];
+    }
+    uint32_t perSlot = (SAVES + ring.slots - 1) / ring.slots;
+    expect(maxWear <= perSlot, "wear spread across the ring");
+    printf("round trip: %u saves, max %u writes per byte (%u per slot)\n", SAVES, (unsigned)maxWear,
+           (unsigned)perSlot);
+}
+
+// seq 0xFFFF → 0x0000: новейшая запись — с меньшим номером
+static void testSeqWrap() {
+    eraseMemory();
+    StorageRing ring = stateRing();
+    ring.valid = true;
+    ring.slot = ring.slots - 1;
+    ring.seq = 0xFFF0;
+
+    for (unsigned i = 0; i < 40; i++) {
+        CubeSatSnapshot s = snapshot(STATE_SCAN_VERTICAL, (uint8_t)i);
+        storageRingSave(mem, ring, &s);
+
+        StorageRing loaded = stateRing();
+        CubeSatSnapshot back;
+        if (!storageRingLoad(mem, loaded, &back) || back.step != (uint8_t)i || loaded.seq != ring.seq) {
+            expect(false, "newest record chosen across seq wrap");
+            return;
+        }
+    }
+    expect(ring.seq == (uint16_t)(0xFFF0 + 40), "seq wrapped");
+    printf("seq wrap: 0xFFF0 -> 0x%04X, newest record chosen at every step\n", ring.seq);
+}
+
+// Сброс посреди записи: новая запись не проходит CRC, берётся предыдущая
+static void testTornWrite() {
+    unsigned survived = 0, total = 0;
+
+    for (long cut = 0; cut < (long)(sizeof(CubeSatSnapshot) + STORAGE_RECORD_OVERHEAD); cut++) {
+        eraseMemory();
+        StorageRing ring = stateRing();
+        CubeSatSnapshot a = snapshot(STATE_SCAN_DIAGONAL_1, 10);
+        CubeSatSnapshot b = snapshot(STATE_SCAN_DIAGONAL_1, 11);
+        storageRingSave(mem, ring, &a);
+        storageRingSave(mem, ring, &a);
+
+        tornAfter = cut;
+        storageRingSave(mem, ring, &b);
+        tornAfter = -1;
+
+        StorageRing loaded = stateRing();
+        CubeSatSnapshot back;
+        total++;
+        if (storageRingLoad(mem, loaded, &back) && back.step == 10) survived++;
+    }
+    expect(survived == total, "torn write falls back to the previous record");
+    printf("torn write: previous record recovered in %u of %u cut points\n", survived, total);
+}
+
+static void testCorruptByte() {
+    eraseMemory();
+    StorageRing ring = configRing();
+    CubeSatConfig a = {3000, 300, 1000, 2000, 1100, 2100};
+    CubeSatConfig b = a;
+    b.telemetryMs = 1000;
+    storageRingSave(mem, ring, &a);
+    storageRingSave(mem, ring, &b);
+
+    // Бит данных последней записи
+    memory[ring.base + ring.slot * (ring.size + STORAGE_RECORD_OVERHEAD) + 3] ^= 0x10;
+
+    StorageRing loaded = configRing();
+    CubeSatConfig back;
+    expect(storageRingLoad(mem, loaded, &back) && back.telemetryMs == 3000, "corrupt record skipped by CRC");
+}
+
+// Решение storageSetup() по флагам MCUSR
+static void testRestoreMode() {
+    const uint8_t EXTRF = 0x02, WDRF = 0x08;
+    CubeSatSnapshot s = snapshot(STATE_SCAN_HORIZONTAL, 5);
+
+    expect(storageRestoreMode(s, RESET_PORF) == STORAGE_POSITION && s.brownouts == 0, "power-on: position only");
+    expect(storageRestoreMode(s, RESET_PORF | RESET_BORF) == STORAGE_POSITION && s.brownouts == 0,
+           "power-on with BORF is not a brown-out");
+    expect(storageRestoreMode(s, EXTRF) == STORAGE_POSITION && s.brownouts == 0, "external reset: position only");
+    expect(storageRestoreMode(s, WDRF) == STORAGE_POSITION && s.brownouts == 0, "watchdog reset: position only");
+
+    for (uint8_t i = 1; i < STORAGE_BROWNOUT_LIMIT; i++) {
+        expect(storageRestoreMode(s, RESET_BORF) == STORAGE_RESUME && s.brownouts == i, "brown-out resumes the mode");
+    }
+    expect(storageRestoreMode(s, RESET_BORF) == STORAGE_POSITION && s.brownouts == STORAGE_BROWNOUT_LIMIT,
+           "brown-out number STORAGE_BROWNOUT_LIMIT stays IDLE");
+    expect(storageRestoreMode(s, RESET_BORF) == STORAGE_POSITION && s.brownouts == STORAGE_BROWNOUT_LIMIT + 1,
+           "further brown-outs stay IDLE");
+
+    CubeSatSnapshot idle = snapshot(STATE_IDLE, 0);
+    expect(storageRestoreMode(idle, RESET_BORF) == STORAGE_POSITION && idle.brownouts == 1,
+           "brown-out in IDLE: nothing to resume");
+
+    CubeSatSnapshot saturated = snapshot(STATE_SCAN_HORIZONTAL, 0);
+    saturated.brownouts = 0xFF;
+    storageRestoreMode(saturated, RESET_BORF);
+    expect(saturated.brownouts == 0xFF, "brown-out counter saturates");
+}
+
+int main() {
+    testLayout();
+    testEmpty();
+    testRoundTripAndWear();
+    testSeqWrap();
+    testTornWrite();
+    testCorruptByte();
+    testRestoreMode();
+
+    if (failures) {
+        printf("\nSTORAGE TEST FAILED: %d checks\n", failures);
+        return 1;
+    }
+    printf("\nstorage test passed\n");
+    return 0;
+}
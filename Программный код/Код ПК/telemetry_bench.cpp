@@ -0,0 +1,271 @@
+// telemetry_bench.cpp
+// Стенд пакетного разбора телеметрии (TelemetryBatch.cpp): сверка всех
+// путей с CRC и проверкой прошивки и скорость в записях в секунду.
+//
+// Сборка:
+//   g++ -O2 -std=c++17 telemetry_bench.cpp TelemetryBatch.cpp -o telemetry_bench
+// Запуск:
+//   ./telemetry_bench [--frames N] [--repeat R] [--seed S] [--corrupt FRACTION]
+//                     [--file ARCHIVE]
+// ARCHIVE — записи NRF_CS2BS по 24 байта подряд. Код выхода 1 — расхождение.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../Код Cubesat/Data_Structures.h"
+#include "TelemetryBatch.h"
+
+struct BenchConfig {
+    size_t frames = 1000000;
+    int repeat = 5;
+    uint64_t seed = 1;
+    double corrupt = 0.05;      // доля записей с искажением
+    const char *file = nullptr;
+};
+
+static const BatchPath PATHS[] = {BATCH_SCALAR, BATCH_SSE42, BATCH_AVX2};
+
+// ══════════════════════════════════════════════════════════════
+// ТЕСТОВЫЕ ЗАПИСИ
+// ══════════════════════════════════════════════════════════════
+// Правдоподобная телеметрия с искажениями: бит в эфире, чужой заголовок,
+// чужой ID, случайные байты
+static std::vector<uint8_t> makeRecords(const BenchConfig &cfg) {
+    std::mt19937_64 rng(cfg.seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<uint8_t> data(cfg.frames * TELEMETRY_RECORD_SIZE);
+    uint32_t timestamp = 0;
+
+    for (size_t i = 0; i < cfg.frames; i++) {
+        NRF_CS2BS p;
+        for (uint8_t &b : p.raw) b = (uint8_t)rng();
+        timestamp += 100 + rng() % 3000;
+        p.fields.last_cmd_num = (uint8_t)(i / 3);
+        p.fields.timestamp = timestamp;
+        p.fields.status = (uint8_t)(rng() & 0x3F);
+        p.fields.mode = (uint8_t)(rng() % 7);
+        p.fields.pwm_x = (uint16_t)(500 + rng() % 2001);
+        p.fields.pwm_y = (uint16_t)(500 + rng() % 2001);
+        p.fields.pos_x = (int8_t)((int)(rng() % 81) - 40);
+        p.fields.pos_y = (int8_t)((int)(rng() % 81) - 40);
+        sealTelemetryPacket(p, (uint8_t)i);
+
+        if (u(rng) < cfg.corrupt) {
+            switch (rng() % 4) {
+                case 0: p.raw[rng() % 24] ^= (uint8_t)(1u << (rng() % 8)); break;
+                case 1: p.fields.header = PACKET_HEADER_CMD; break;
+                case 2: p.fields.sat_id ^= 0x40; break;
+                default: for (uint8_t &b : p.raw) b = (uint8_t)rng(); break;
+            }
+        }
+        memcpy(&data[i * TELEMETRY_RECORD_SIZE], p.raw, TELEMETRY_RECORD_SIZE);
+    }
+    return data;
+}
+
+static bool loadRecords(const char *path, std::vector<uint8_t> &data) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t buf[1 << 16];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    data.resize(data.size() / TELEMETRY_RECORD_SIZE * TELEMETRY_RECORD_SIZE);
+    return true;
+}
+
+// ══════════════════════════════════════════════════════════════
+// ЭТАЛОН: ПОЗАПИСНЫЙ РАЗБОР, КАК В ПРОШИВКЕ БС
+// ══════════════════════════════════════════════════════════════
+static size_t decodeReference(const uint8_t *records, size_t count, TelemetryColumns &out) {
+    out.resize(count);
+    size_t ok = 0;
+    for (size_t i = 0; i < count; i++) {
+        NRF_CS2BS p;
+        memcpy(p.raw, records + i * TELEMETRY_RECORD_SIZE, sizeof(p.raw));
+        out.check[i] = checkTelemetryPacket(p);
+        out.packetNum[i] = p.fields.packet_num;
+        out.lastCmdNum[i] = p.fields.last_cmd_num;
+        out.timestamp[i] = p.fields.timestamp;
+        out.status[i] = p.fields.status;
+        out.mode[i] = p.fields.mode;
+        out.scriptStep[i] = p.fields.script_step;
+        out.pwmX[i] = p.fields.pwm_x;
+        out.pwmY[i] = p.fields.pwm_y;
+        out.posX[i] = p.fields.pos_x;
+        out.posY[i] = p.fields.pos_y;
+        out.pwrLaser[i] = p.fields.pwr_laser;
+        out.pwrServo[i] = p.fields.pwr_servo;
+        out.acqTime[i] = p.fields.acq_time;
+        out.acqError[i] = p.fields.acq_error;
+        ok += out.check[i] == PACKET_OK;
+    }
+    return ok;
+}
+
+// ══════════════════════════════════════════════════════════════
+// СВЕРКА
+// ══════════════════════════════════════════════════════════════
+static int failures = 0;
+
+static void expect(bool ok, const char *what, BatchPath path, size_t index) {
+    if (ok) return;
+    if (failures++ < 20) fprintf(stderr, "MISMATCH %s [%s] at record %zu\n", what, batchPathName(path), index);
+}
+
+#define SAME_COLUMN(col) expect(a.col == b.col, #col, path, firstDiff(a.col, b.col))
+
+template <typename T>
+static size_t firstDiff(const std::vector<T> &a, const std::vector<T> &b) {
+    size_t i = 0;
+    while (i < a.size() && i < b.size() && a[i] == b[i]) i++;
+    return i;
+}
+
+static void compareColumns(const TelemetryColumns &a, const TelemetryColumns &b, BatchPath path) {
+    SAME_COLUMN(check);
+    SAME_COLUMN(packetNum);
+    SAME_COLUMN(lastCmdNum);
+    SAME_COLUMN(timestamp);
+    SAME_COLUMN(status);
+    SAME_COLUMN(mode);
+    SAME_COLUMN(scriptStep);
+    SAME_COLUMN(pwmX);
+    SAME_COLUMN(pwmY);
+    SAME_COLUMN(posX);
+    SAME_COLUMN(posY);
+    SAME_COLUMN(pwrLaser);
+    SAME_COLUMN(pwrServo);
+    SAME_COLUMN(acqTime);
+    SAME_COLUMN(acqError);
+}
+
+static void selfCheck(const std::vector<uint8_t> &data, size_t count) {
+    // Контрольное значение CRC-16/XMODEM для "123456789"
+    const uint8_t digits[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    expect(calculateCRC16(digits, sizeof(digits)) == 0x31C3, "firmware CRC check value", BATCH_SCALAR, 0);
+
+    // CRC каждой записи — бит в бит packetCRC16()
+    std::vector<uint16_t> crc(count);
+    for (BatchPath path : PATHS) {
+        if (!batchPathSupported(path)) continue;
+        batchCRC16(data.data(), count, crc.data(), path);
+        for (size_t i = 0; i < count; i++) {
+            expect(crc[i] == packetCRC16(&data[i * TELEMETRY_RECORD_SIZE]), "crc", path, i);
+        }
+    }
+
+    // Любой одиночный бит в исправной записи даёт ошибку на всех путях
+    NRF_CS2BS p;
+    memset(&p, 0x5A, sizeof(p));
+    sealTelemetryPacket(p, 7);
+    std::vector<uint8_t> flips;
+    for (unsigned bit = 0; bit < 8 * TELEMETRY_RECORD_SIZE; bit++) {
+        NRF_CS2BS q = p;
+        q.raw[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        flips.insert(flips.end(), q.raw, q.raw + TELEMETRY_RECORD_SIZE);
+    }
+    TelemetryColumns cols;
+    for (BatchPath path : PATHS) {
+        if (!batchPathSupported(path)) continue;
+        expect(decodeTelemetryBatch(flips.data(), 8 * TELEMETRY_RECORD_SIZE, cols, path) == 0, "bit flip detection", path, 0);
+    }
+
+    // Все столбцы совпадают с позаписным разбором; длины с хвостами
+    TelemetryColumns ref;
+    size_t lengths[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 17, count};
+    for (size_t n : lengths) {
+        n = std::min(n, count);
+        size_t refOk = decodeReference(data.data(), n, ref);
+        for (BatchPath path : PATHS) {
+            if (!batchPathSupported(path)) continue;
+            size_t ok = decodeTelemetryBatch(data.data(), n, cols, path);
+            expect(ok == refOk, "ok count", path, n);
+            compareColumns(ref, cols, path);
+        }
+    }
+}
+
+// ══════════════════════════════════════════════════════════════
+// СКОРОСТЬ
+// ══════════════════════════════════════════════════════════════
+template <typename F>
+static double bestSeconds(int repeat, F run) {
+    double best = 1e30;
+    for (int r = 0; r < repeat; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+static void report(const char *name, size_t count, double seconds, double baseline) {
+    double fps = count / seconds;
+    printf("%-22s %8.1f Mframes/s  %7.1f MB/s  ×%5.1f\n",
+           name, fps / 1e6, fps * TELEMETRY_RECORD_SIZE / 1e6, baseline / seconds);
+}
+
+int main(int argc, char **argv) {
+    BenchConfig cfg;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--frames")) cfg.frames = strtoull(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--repeat")) cfg.repeat = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--seed")) cfg.seed = strtoull(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--corrupt")) cfg.corrupt = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--file")) cfg.file = argv[i + 1];
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> data;
+    if (cfg.file) {
+        if (!loadRecords(cfg.file, data)) {
+            fprintf(stderr, "cannot read %s\n", cfg.file);
+            return 1;
+        }
+    } else {
+        data = makeRecords(cfg);
+    }
+    size_t count = data.size() / TELEMETRY_RECORD_SIZE;
+
+    selfCheck(data, count);
+
+    TelemetryColumns cols;
+    size_t ok = decodeReference(data.data(), count, cols);
+    size_t bad[4] = {0};
+    for (uint8_t c : cols.check) bad[c]++;
+    printf("%zu records | ok %zu | bad header %zu | bad sat id %zu | bad crc %zu | best path %s\n\n",
+           count, ok, bad[PACKET_BAD_HEADER], bad[PACKET_BAD_SAT_ID], bad[PACKET_BAD_CRC],
+           batchPathName(batchBestPath()));
+
+    double firmware = bestSeconds(cfg.repeat, [&] { decodeReference(data.data(), count, cols); });
+    report("firmware bit-serial", count, firmware, firmware);
+    for (BatchPath path : PATHS) {
+        if (!batchPathSupported(path)) continue;
+        char name[32];
+        snprintf(name, sizeof(name), "batch %s", batchPathName(path));
+        report(name, count, bestSeconds(cfg.repeat, [&] { decodeTelemetryBatch(data.data(), count, cols, path); }), firmware);
+    }
+    std::vector<uint16_t> crc(count);
+    for (BatchPath path : PATHS) {
+        if (!batchPathSupported(path) || path == BATCH_AVX2) continue;
+        char name[32];
+        snprintf(name, sizeof(name), "crc only %s", path == BATCH_SCALAR ? "table" : "clmul");
+        report(name, count, bestSeconds(cfg.repeat, [&] { batchCRC16(data.data(), count, crc.data(), path); }), firmware);
+    }
+
+    if (failures) {
+        printf("\nSELF-CHECK FAILED: %d mismatches\n", failures);
+        return 1;
+    }
+    printf("\nself-check passed: all paths bit-exact with firmware CRC and checkTelemetryPacket()\n");
+    return 0;
+}